@@ -26,6 +26,7 @@ namespace Component {
 */
 
 class Network;
+class NetworkView;
 
 class Network : public CommonConceptGraph
 {
@@ -87,6 +88,47 @@ class Network : public CommonConceptGraph
         Hyperedges aliasOf(const Hyperedges& aliasInterfaceUids, const Hyperedges& originalInterfaceUids);
 };
 
+/*
+    A NetworkView answers the queries of a Network on a borrowed graph.
+
+    It neither copies the graph nor creates the main concepts.
+    Therefore it is the cheap way to interpret e.g. a ResourceCost::Model as a Component::Network (for example inside of partition or match functions).
+    NOTE: The borrowed graph has to outlive the view.
+*/
+
+class NetworkView
+{
+    public:
+        NetworkView(const CommonConceptGraph& ccg);
+        ~NetworkView();
+
+        // Access to the borrowed graph
+        const CommonConceptGraph& graph() const;
+        const Hyperedge& access(const UniqueId& uid) const;
+
+        // Query classes
+        Hyperedges componentClasses(const std::string& name="", const Hyperedges& suids=Hyperedges{Network::ComponentId}) const;
+        Hyperedges interfaceClasses(const std::string& name="", const Hyperedges& suids=Hyperedges{Network::InterfaceId}) const;
+
+        // Query individuals
+        Hyperedges components(const std::string& name="", const std::string& className="") const;
+        Hyperedges interfaces(const std::string& name="", const std::string& className="") const;
+
+        // Query component interfaces
+        Hyperedges interfacesOf(const Hyperedges& uids, const std::string& name="", const Hypergraph::TraversalDirection dir=Hypergraph::FORWARD) const;
+        // Query original interfaces of alias interfaces
+        Hyperedges originalInterfacesOf(const Hyperedges& uids, const std::string& name="", const Hypergraph::TraversalDirection dir=Hypergraph::FORWARD) const;
+        // Query the subinterfaces of an interface
+        Hyperedges subinterfacesOf(const Hyperedges& uids, const std::string& name="", const Hypergraph::TraversalDirection dir=Hypergraph::FORWARD) const;
+        // Query the subcomponents of a component
+        Hyperedges subcomponentsOf(const Hyperedges& uids, const std::string& name="", const Hypergraph::TraversalDirection dir=Hypergraph::INVERSE) const;
+        // Query the interfaces connected to interfaces
+        Hyperedges endpointsOf(const Hyperedges& uids, const std::string& name="", const Hypergraph::TraversalDirection dir=Hypergraph::FORWARD) const;
+
+    protected:
+        const CommonConceptGraph& ccg;
+};
+
 }
 
 #endif
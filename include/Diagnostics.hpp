@@ -0,0 +1,114 @@
+#ifndef _DIAGNOSTICS_HPP
+#define _DIAGNOSTICS_HPP
+
+#include <atomic>
+#include <ostream>
+#include <sstream>
+#include <string>
+
+/*
+    DIAGNOSTICS
+
+    While mapping, the match functions reject many consumer/provider pairs and printing every rejection dominates the runtime of large models.
+    Therefore, all messages of the mapping are reported to a global sink instead:
+    * Every message has a level and is only written if the level of the sink is at least as high (default: INFO).
+      Rejections have level DEBUG, so they are not written by default.
+    * Messages are only formatted if they are written (see DIAGNOSE), so a disabled message costs a single comparison.
+    * Rejections are counted per rule, if counting is enabled (default: disabled).
+      The counters can be written as a histogram or as JSON afterwards.
+
+    Defining DIAGNOSTICS_DISABLED at compile time removes all reports (and thus the counters) altogether.
+*/
+
+namespace Diagnostics {
+
+enum Level {
+    SILENT = 0,
+    ERROR = 1,
+    WARNING = 2,
+    INFO = 3,
+    DEBUG = 4
+};
+
+// The rules which reject (or drop) something while mapping
+enum Rule {
+    SAT_INSUFFICIENT = 0,
+    SAT_NO_RESOURCES,
+    PARTITION_INTERNAL_INTERFACE,
+    REACH_UNKNOWN_INTERFACE,
+    REACH_OWNER_NOT_MAPPED,
+    REACH_OWNER_MISMATCH,
+    REACH_ENDPOINTS_UNREACHABLE,
+    REACH_ENDPOINT_OWNERS_UNMAPPED,
+    REACH_ENDPOINT_OWNERS_MISMATCH,
+    REACH_NEIGHBOURS_UNREACHABLE,
+    BANDWIDTH_LINK_OVERSUBSCRIBED,
+    COMPLETENESS_NO_PROVIDER,
+    NUM_RULES
+};
+
+// NOTE: These are only exposed for the inline checks below
+// NOTE: They are read by the threads of a mapping while they may be changed, so they are atomic (relaxed loads suffice)
+extern std::atomic< int > currentLevel;
+extern std::atomic< bool > countingEnabled;
+extern std::atomic< unsigned long > counters[NUM_RULES];
+
+// Get/Set the level of the sink
+Level level();
+void level(const Level l);
+// Get/Set if rejections are counted
+bool counting();
+void counting(const bool enabled);
+// Get/Set the stream messages are written to (default: std::cout)
+std::ostream& sink();
+void sink(std::ostream& os);
+
+inline bool enabled(const Level l)
+{
+    return (currentLevel.load(std::memory_order_relaxed) >= l);
+}
+
+inline void count(const Rule rule)
+{
+    if (countingEnabled.load(std::memory_order_relaxed))
+        counters[rule].fetch_add(1, std::memory_order_relaxed);
+}
+
+// Writes a message (as a line) to the sink
+void write(const Level l, const std::string& message);
+
+const char* nameOf(const Rule rule);
+unsigned long countOf(const Rule rule);
+unsigned long totalCount();
+void reset();
+
+// Writes the counters as a histogram (one line per rule which has been counted)
+void summary(std::ostream& os);
+// Writes the counters as a JSON object
+void json(std::ostream& os);
+
+}
+
+#ifndef DIAGNOSTICS_DISABLED
+// Reports a message (anything which can be streamed) at the given level
+#define DIAGNOSE(lvl, message) \
+    do { \
+        if (Diagnostics::enabled(lvl)) \
+        { \
+            std::ostringstream diagnosticsMessage; \
+            diagnosticsMessage << message; \
+            Diagnostics::write(lvl, diagnosticsMessage.str()); \
+        } \
+    } while (0)
+// Counts a rejection by the given rule and reports a message at the given level
+#define DIAGNOSE_RULE(rule, lvl, message) \
+    do { \
+        Diagnostics::count(rule); \
+        DIAGNOSE(lvl, message); \
+    } while (0)
+#else
+#define DIAGNOSE(lvl, message) do {} while (0)
+#define DIAGNOSE_RULE(rule, lvl, message) do {} while (0)
+#endif
+
+#endif
@@ -59,6 +59,26 @@ class Network: public Component::Network
         Hyperedges interfaces(const Hyperedges& deviceIds=Hyperedges(), const std::string& name="", const std::string& className="") const; //< If a deviceId is given, only its interfaces are returned
 };
 
+/*
+    A NetworkView answers the queries of a Hardware::Computational::Network on a borrowed graph without copying it (see Component::NetworkView)
+*/
+class NetworkView : public Component::NetworkView
+{
+    public:
+        NetworkView(const CommonConceptGraph& ccg);
+        ~NetworkView();
+
+        // NOTE: These return the subclasses of the corresponding main concepts
+        Hyperedges deviceClasses(const std::string& name="", const Hyperedges& suids=Hyperedges()) const;
+        Hyperedges processorClasses(const std::string& name="", const Hyperedges& suids=Hyperedges()) const;
+        Hyperedges interfaceClasses(const std::string& name="", const Hyperedges& suids=Hyperedges()) const;
+
+        // NOTE: These return the individuals of all the corresponding classes
+        Hyperedges devices(const std::string& name="", const std::string& className="") const;
+        Hyperedges processors(const std::string& name="", const std::string& className="") const;
+        Hyperedges interfaces(const Hyperedges& deviceIds=Hyperedges(), const std::string& name="", const std::string& className="") const; //< If a deviceId is given, only its interfaces are returned
+};
+
 }
 }
 
@@ -4,6 +4,11 @@
 #include "SoftwareNetwork.hpp"
 #include "HardwareComputationalNetwork.hpp"
 #include "ResourceCostModel.hpp"
+#include "ResourceCostSolver.hpp"
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
 
 namespace Software
 {
@@ -11,6 +16,160 @@ namespace Software
 namespace Hardware
 {
 
+/*
+    REACHABILITY CLASS
+
+    An index of the topology of all sw implementations and hw devices (including processors) of a model.
+    Every interface and component gets an integer index and the index stores
+    * interface -> owners
+    * interface -> adjacent interfaces and the owners of these
+    * component -> adjacent components
+    as sorted arrays of these integers.
+    Components which are only reachable through others (e.g. switches or gateways) are indexed as well.
+
+    On top of that, it routes between the hw components: The number of hops between any two of them is computed once by breadth-first search.
+    Two hw components can reach each other if they are at most maxHops links apart (maxHops=1 means only directly connected components).
+    The links (pairs of connected interfaces) along a shortest route can be reconstructed as well.
+    NOTE: If two components are connected by several links, routes use the first one found.
+
+    The topology does not change while mapping, so it is built once per mapping run.
+    Then the reachability rules of the Mapper only have to look up the (changing) mappings in the graph.
+*/
+
+class Reachability : public ResourceCost::RunContext
+{
+    public:
+        static const unsigned int Unreachable;
+        // A link between two interfaces (the smaller node first)
+        typedef std::pair< std::size_t, std::size_t > Link;
+
+        Reachability(const ResourceCost::Model& rcm, const unsigned int maxHops=1);
+
+        // Returns the index of a uid or -1 if it is not part of the topology
+        int indexOf(const UniqueId& uid) const;
+        Hyperedges uidsOf(const std::vector< std::size_t >& nodes) const;
+        // Checks if a uid is one of the given nodes
+        bool contains(const std::vector< std::size_t >& nodes, const UniqueId& uid) const;
+
+        const std::vector< std::size_t >& ownersOf(const std::size_t node) const;
+        const std::vector< std::size_t >& adjacentInterfacesOf(const std::size_t node) const;
+        const std::vector< std::size_t >& adjacentOwnersOf(const std::size_t node) const;
+        const std::vector< std::size_t >& adjacentComponentsOf(const std::size_t node) const;
+
+        // Routing between hw components
+        unsigned int maxHops() const;
+        // Returns the number of links between two hw components (0 for the same component) or Unreachable
+        unsigned int hopsBetween(const std::size_t componentNodeA, const std::size_t componentNodeB) const;
+        // Returns the number of links from a hw interface to some hw component (leaving through the link of the interface)
+        unsigned int hopsFrom(const std::size_t interfaceNode, const std::size_t componentNode) const;
+        // Returns the number of links from a hw interface to another one (leaving and arriving through their links)
+        unsigned int hopsVia(const std::size_t interfaceNodeA, const std::size_t interfaceNodeB) const;
+        // Convenience functions for uids which check the hop limit
+        bool reachable(const UniqueId& componentUidA, const UniqueId& componentUidB) const;
+        bool reachableFrom(const UniqueId& interfaceUid, const UniqueId& componentUid) const;
+        bool reachableVia(const UniqueId& interfaceUidA, const UniqueId& interfaceUidB) const;
+        // Returns the links of a shortest route from a hw interface to another one (see hopsVia) or nothing if they cannot reach each other
+        std::vector< Link > linksVia(const std::size_t interfaceNodeA, const std::size_t interfaceNodeB) const;
+        const UniqueId& uidOf(const std::size_t node) const;
+
+    protected:
+        std::size_t nodeOf(const UniqueId& uid);
+        // Indexes the given components (and everything connected to them) and returns the nodes of all indexed components
+        std::vector< std::size_t > index(const Component::NetworkView& net, const Hyperedges& componentUids);
+        void route(const std::vector< std::size_t >& componentNodes);
+
+        std::vector< UniqueId > uids;
+        std::unordered_map< UniqueId, std::size_t > indices;
+        std::vector< std::vector< std::size_t > > owners;
+        std::vector< std::vector< std::size_t > > adjacentInterfaces;
+        std::vector< std::vector< std::size_t > > adjacentOwners;
+        std::vector< std::vector< std::size_t > > adjacentComponents;
+        // Some link between two adjacent components
+        std::map< std::pair< std::size_t, std::size_t >, Link > componentLinks;
+
+        unsigned int hopLimit;
+        // Routing table: slot of a node (or -1 for non hw components) and hops between the slots
+        std::vector< int > routingSlots;
+        std::size_t routingWidth;
+        std::vector< std::size_t > routedNodes;
+        std::vector< unsigned int > hops;
+        // Predecessor slots on the shortest routes (from the row slot to the column slot)
+        std::vector< int > predecessors;
+};
+
+/*
+    COMMUNICATION OBJECTIVE CLASS
+
+    Implementations which depend on each other (i.e. have connected interfaces) exchange data.
+    If they are mapped to different processors, the data has to travel over the links between them.
+    Thus, the costs between two neighbouring implementations are their TRAFFIC times the number of HOPS between their processors.
+
+    The TRAFFIC between two implementations is the sum over all connections between their interfaces.
+    A connection carries the greater DATA-RATE of both interfaces (see Mapper::mapAllSwAndHwInterfaces) or 1 if none of them declares one.
+    The costs are normalized by the total traffic (so they are the mean number of hops a unit of traffic travels) and weighted.
+*/
+
+class CommunicationObjective : public ResourceCost::Objective
+{
+    public:
+        CommunicationObjective(const ResourceCost::Model& rcm, const Reachability& reachability, const double weight=1.0);
+
+        Hyperedges neighboursOf(const UniqueId& implementationUid) const;
+        double costsBetween(const UniqueId& implementationUidA, const UniqueId& processorUidA, const UniqueId& implementationUidB, const UniqueId& processorUidB) const;
+
+        // Returns the traffic between two implementations
+        double trafficBetween(const UniqueId& implementationUidA, const UniqueId& implementationUidB) const;
+        double totalTraffic() const;
+
+    protected:
+        const Reachability& reachability;
+        double costWeight;
+        // Traffic between two implementations (the smaller node first)
+        std::map< std::pair< std::size_t, std::size_t >, double > traffic;
+        std::unordered_map< UniqueId, Hyperedges > neighbours;
+        double total;
+};
+
+/*
+    MAPPING CACHE CLASS
+
+    Stores the results of mapping runs in a directory (one file per canonical hash of the input, see Mapper::canonicalHash).
+    The files are kept in one subdirectory per hardware hash, so a search for similar entries only reads the ones for the same hardware.
+    Such a file lists the hash of the hardware, the hashes of all implementations and the EXECUTED-ON and REACHABLE-VIA facts of the result.
+    Thus
+    * an unchanged input can be restored without solving anything and
+    * a changed input can start from the entry for the same hardware which shares most (unchanged) implementations.
+    NOTE: Entries are written to a temporary file first and then renamed, so concurrent runs never read partial entries.
+*/
+
+class MappingCache
+{
+    public:
+        struct Entry
+        {
+            std::string hardwareHash;
+            std::map< UniqueId, std::string > implementationHashes;
+            std::vector< std::pair< UniqueId, UniqueId > > executedOn;
+            std::vector< std::pair< UniqueId, UniqueId > > reachableVia;
+        };
+
+        // Creates the directory if necessary
+        MappingCache(const std::string& directory);
+
+        // Returns the entry of a hash for the given hardware (if any)
+        bool find(const std::string& hardwareHash, const std::string& hash, Entry& entry) const;
+        // Returns the entry for the given hardware which shares most implementations (and their number)
+        std::size_t findSimilar(const std::string& hardwareHash, const std::map< UniqueId, std::string >& implementationHashes, Entry& entry) const;
+        bool store(const std::string& hash, const Entry& entry) const;
+
+    protected:
+        // Returns the subdirectory of a hardware hash
+        std::string dirNameOf(const std::string& hardwareHash) const;
+        bool read(const std::string& fileName, Entry& entry) const;
+
+        std::string dirName;
+};
+
 /*
 */
 
@@ -19,33 +178,185 @@ class Mapper : public ResourceCost::Model
     public:
         static const UniqueId ExecutedOnUid;
         static const UniqueId ReachableViaUid;
+        static const UniqueId DataRateUid;
 
         Mapper(const ResourceCost::Model& rcm,
                const Software::Network& sw = Software::Network(),
                const ::Hardware::Computational::Network& hw = ::Hardware::Computational::Network()
               );
+        // Imports the base of the overlay and adds its delta (so the variant is never flattened into a copy of its own)
+        Mapper(const ResourceCost::Model& rcm,
+               const Software::NetworkOverlay& sw,
+               const ::Hardware::Computational::Network& hw = ::Hardware::Computational::Network()
+              );
+
+        // Get/Set the number of threads used to precompute the scores of all consumer/provider pairs
+        unsigned int threads() const;
+        void threads(const unsigned int n);
+        // Get/Set the maximum number of links between the processors of communicating implementations (default: 1, i.e. directly connected)
+        unsigned int maxHops() const;
+        void maxHops(const unsigned int n);
+        // Get/Set the weight of the communication costs in the objective (default: 1, 0 ignores communication)
+        double communicationWeight() const;
+        void communicationWeight(const double w);
         
         static Hyperedges implementations (const ResourceCost::Model& rcm);
+        // Implementations which are not mapped to any processor yet
+        static Hyperedges unmappedImplementations (const ResourceCost::Model& rcm);
         static Hyperedges processors (const ResourceCost::Model& rcm);
         static float matchImplementationAndProcessor (const ResourceCost::Model& rcm, const UniqueId& consumerUid, const UniqueId& providerUid);
         static void mapImplementationToProcessor (CommonConceptGraph& ccg, const UniqueId& consumerUid, const UniqueId& providerUid); 
+        // Processors are equivalent if they are of the same classes, have the same resources and the same neighbours
+        static bool equivalentProcessors (const ResourceCost::Model& rcm, const UniqueId& providerUidA, const UniqueId& providerUidB);
 
-        /* Uses the implemented functions to map software implementations to hardware processors */
-        float mapAllImplementationsToProcessors();
+        /*
+            Uses the implemented functions and the given solver to map software implementations to hardware processors
+            NOTE: Implementations which are mapped already keep their processors
+        */
+        float mapAllImplementationsToProcessors(const ResourceCost::Solver& solver = ResourceCost::Solver());
+        /* Returns the normalized residual resources of all processors (or -inf if some implementation is not mapped) */
+        float globalCosts() const;
+        /* Returns the (unweighted) communication costs of the mapped implementations (see CommunicationObjective) */
+        float communicationCosts() const;
+        /*
+            Returns the objective all strategies optimize: globalCosts() - communicationWeight() * communicationCosts()
+            NOTE: Greater means better (like globalCosts)
+        */
+        float objective() const;
+        /* Improves the mapping of implementations to processors by local search. Afterwards, sw interfaces are re-mapped to hw interfaces */
+        float improve(const ResourceCost::AnnealingSolver& annealer = ResourceCost::AnnealingSolver());
 
         static Hyperedges swInterfaces (const ResourceCost::Model& rcm);
         static Hyperedges hwInterfaces (const ResourceCost::Model& rcm);
         static float matchSwToHwInterface (const ResourceCost::Model& rcm, const UniqueId& consumerUid, const UniqueId& providerUid);
         static void mapSwToHwInterface (CommonConceptGraph& ccg, const UniqueId& consumerUid, const UniqueId& providerUid); 
         
-        /* Uses the implemented functions to map software to hardware interfaces */
+        /*
+            Uses the implemented functions to map software to hardware interfaces
+
+            Additionally, the data flowing between connected sw interfaces has to fit through the hw links it is routed over:
+            * A sw interface declares its data rate by NEEDS of DATA-RATE (see DataRateUid). The flow between two connected sw interfaces has the greater rate of both.
+            * A hw interface declares the capacity of its link(s) by PROVIDES of DATA-RATE. A link has the smaller capacity of both ends (or none, if no end declares one).
+            The flows of all mapped sw interfaces are aggregated per link and a sw interface is only mapped if all links on the routes of its flows can carry them.
+        */
         float mapAllSwAndHwInterfaces();
+        // Returns the data rate routed over a link between two hw interfaces by the current mapping
+        float linkLoadOf(const UniqueId& hwInterfaceUidA, const UniqueId& hwInterfaceUidB) const;
 
         /*
-            I. map implementations to processors
+            I. map implementations to processors (using the given solver)
             II. map sw to hw interfaces
+            NOTE: Step II depends on the mapping of the neighbouring interfaces, so it is always done greedily
+            Returns the mean costs of both steps (step II adds none, so it is globalCosts() / 2) or the negative costs of the step which failed.
+        */
+        float map(const ResourceCost::Solver& solver = ResourceCost::Solver());
+
+        /*
+            Like map(), but maps implementations to processors level by level along the PART-OF hierarchy of the devices (see Component::Network::subcomponentsOf):
+            * On every level, the processors are grouped by the devices they are part of. A group offers the sum of the resources of its processors.
+              Implementations are assigned to the groups greedily (largest demand first), keeping as many resources and as much traffic within the groups as possible.
+            * Every group is split by the devices it is composed of, until the groups are single processors.
+              These subproblems are independent of each other and solved in parallel (see threads()) by the given solver.
+            Implementations which could not be mapped within their group are finally mapped using all processors (see map()).
+            NOTE: Routes between different groups are only checked when mapping the interfaces, so a hop limit may leave sw interfaces unmapped.
+            NOTE: Without any PART-OF relations between devices, this is the same as map()
+        */
+        float mapHierarchically(const ResourceCost::Solver& solver = ResourceCost::Solver());
+
+        /*
+            Like map(), but splits the mapping of implementations to processors into independent subproblems:
+            * The implementations and the processors are grouped by the connected components of their networks (see Reachability).
+            * Every sw component is assigned to one hw component (largest demand first), so its implementations can reach each other.
+            * If a hw component hosts several sw components, they compete for its processors.
+              Then every one of them is solved on its own copy of the model in which the residuals of the consumed resources are reserved in proportion to its demands.
+            The subproblems are solved in parallel (see threads()) by the given solver and merged.
+            Implementations which could not be mapped that way are finally mapped using all processors (see map()).
+        */
+        float mapDecomposed(const ResourceCost::Solver& solver = ResourceCost::Solver());
+
+        /* Returns the number of processors executing some implementation */
+        std::size_t poweredProcessors() const;
+        /* Returns the smallest normalized residual of any resource of any processor (i.e. the slack of the busiest one) */
+        float bottleneckSlack() const;
+        /*
+            Mappings trade off the balance of the load (see bottleneckSlack, greater is better), the communication costs (smaller is better) and the number of powered processors (smaller is better).
+            Instead of a single mapping, this returns copies of this mapper whose (complete) mappings are not dominated by any other mapping found by an epsilon-constraint sweep:
+            * The number of powered processors is limited to k. Only the first k processors in breadth-first order of the hw network may be used, so they stay connected.
+              At most maxLimits limits are tried (evenly spread from 1 to all processors).
+            * For every limit, the given solver is run with every given communication weight.
+            The runs are independent of each other and done in parallel (see threads()).
+            The result is sorted by the number of powered processors, the communication costs and the balance.
         */
-        float map();
+        std::vector< Mapper > paretoFront(const ResourceCost::Solver& solver = ResourceCost::Solver(), const std::vector< double >& weights = std::vector< double >{0.0, 1.0, 4.0}, const std::size_t maxLimits = 32) const;
+
+        /*
+            Canonical hashes of the parts of the model which matter for mapping.
+            They do not depend on the order of the facts in the graph, so e.g. a model stored and loaded again has the same hashes.
+            * The hardware hash covers all devices (and everything connected to them): their classes, resources, interfaces and links.
+            * The hash of an implementation covers its classes, demands, interfaces and the interfaces they are connected to.
+            * The canonical hash combines both with the settings of the mapper and some salt (e.g. the name of the solver).
+        */
+        std::string hardwareHash() const;
+        std::map< UniqueId, std::string > implementationHashes() const;
+        std::string canonicalHash(const std::string& salt = "") const;
+
+        /*
+            Like map(), but uses the given cache:
+            * If it contains the canonical hash (salted with the name of the solver), the cached facts are restored.
+            * Otherwise, unchanged implementations are mapped like in the most similar entry (if they still match) and the others by the solver.
+            Afterwards, the result is stored in the cache.
+        */
+        float map(const ResourceCost::Solver& solver, const MappingCache& cache);
+
+    protected:
+        // Defines the mapping relations and resources
+        void createMainConcepts();
+
+        unsigned int numThreads;
+        unsigned int hopLimit;
+        double commWeight;
+};
+
+/*
+    FEASIBLE IMPLEMENTATION NETWORKS
+
+    Most implementation networks of an algorithm network cannot be mapped to a given hardware at all.
+    So instead of enumerating all of them, the choices of implementations are explored as a search tree (first algorithm first) and a subtree is cut as soon as
+    * the chosen implementation class does not fit on any single processor (see ResourceCost::Model::satisfies) or
+    * the consumed resources of the chosen implementation classes (and a lower bound for the remaining algorithms) exceed the residual resources of all processors.
+    The demands are the ones of the implementation classes (and their superclasses) in the resource cost model.
+    Consumed demands of the same resources are summed up and compared to the total residual amount of the resources which can serve them.
+
+    Both bounds are necessary conditions only: A remaining variant may still fail to map (e.g. because of reachability or fragmentation).
+    The indices of the remaining variants are found once and only these have to be built (see ImplementationNetworks::forEach).
+*/
+class FeasibleImplementationNetworks : public Software::ImplementationNetworks
+{
+    public:
+        FeasibleImplementationNetworks(const Software::Network& algorithmNetwork,
+                                       const ResourceCost::Model& rcm,
+                                       const ::Hardware::Computational::Network& hw);
+
+        // Returns the indices of the variants which passed all bounds (in ascending order)
+        const std::vector< std::size_t >& feasible() const;
+        // Returns the number of subtrees which have been cut
+        std::size_t pruned() const;
+
+    protected:
+        // Explores the choices of the given algorithm (and the ones after it)
+        void search(const std::size_t algorithm, const std::size_t index, const std::vector< float >& consumed);
+
+        // Per algorithm and implementation class (as in implementationClassUids): true if it fits on some processor
+        std::vector< std::vector< bool > > fitting;
+        // Per algorithm and implementation class: the consumed amount of every resource group
+        std::vector< std::vector< std::vector< float > > > consumption;
+        // Per resource group: the total residual amount of all resources which can serve it
+        std::vector< float > capacities;
+        // Per algorithm: the least amount of every resource group the algorithms after it will consume
+        std::vector< std::vector< float > > remaining;
+
+        std::vector< std::size_t > feasibleIndices;
+        std::size_t numPruned;
 };
 
 }
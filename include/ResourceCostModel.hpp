@@ -2,6 +2,9 @@
 #define _RESOURCE_COST_MODEL_HPP
 
 #include "CommonConceptGraph.hpp"
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
 
 namespace ResourceCost {
 
@@ -47,6 +50,8 @@ namespace ResourceCost {
     Whenever a CONSUMER is about to be bound to a PROVIDER, the mapping algorithm should check if:
     For every pair NEEDS N, PROVIDES M of a RESOURCE A holds N <= M
 
+    A provided resource of RESOURCE B can serve a demand of RESOURCE A, iff B is-a A (e.g. RAM can serve a demand for MEMORY but not vice versa).
+
     Furthermore, if a CONSUMER is bound to a PROVIDER:
     Every CONSUMES N will result in an update of PROVIDES M to reflect resource consumption
 
@@ -67,8 +72,48 @@ namespace ResourceCost {
 
     I <= M, J <= M, I+J <= M
 
+    The amount of a resource instance is stored in its label (and thus serialized with the graph).
+    To avoid parsing labels during mapping, every model keeps a resource ledger: a dense array of amounts indexed by resource instance.
+    The ledger is filled on construction and kept in sync by instantiateResource() and amountOf().
+    Furthermore, the ledger keeps track of the amount of every provided resource which is already consumed by mapped consumers.
+    These running totals are updated by mapTo() and unmap(), so a satisfiability check does not depend on the number of consumers mapped so far.
+    NOTE: If resources or mappings are imported by other means (e.g. importFrom()), indexResources() has to be called afterwards.
+
+    For mapping many consumers to many providers, the model can be packed: providers' capacities and residuals (capacity minus usage)
+    as well as consumers' demands are exported as dense (resource classes x entities) float matrices.
+    Then fits() evaluates one consumer against all packed providers in one pass (vectorized, if the CPU supports AVX2).
+    Packed residuals follow mapTo() and unmap(). Any other change of resources or amounts unpacks the model again.
+    Because the packed model is read-only for fits(), the scores of all consumer/provider pairs can be precomputed by several threads.
+
 */
 
+/*
+    RUN CONTEXT
+
+    Match functions are plain functions, so they cannot carry the state of the run they are used in (e.g. an index which is built once per run).
+    Such state can be installed for the current thread as a RunContext instead.
+    Everything which calls match functions from threads of its own (e.g. the MultiStartSolver) installs the context of the calling thread in these threads.
+*/
+class RunContext
+{
+    public:
+        virtual ~RunContext();
+
+        // Returns the context of the current thread (or NULL)
+        static const RunContext* current();
+
+        // Installs a context for the current thread as long as the scope exists
+        class Scope
+        {
+            public:
+                explicit Scope(const RunContext* context);
+                ~Scope();
+
+            protected:
+                const RunContext* previous;
+        };
+};
+
 class Model;
 
 class Model: public CommonConceptGraph
@@ -94,6 +139,17 @@ class Model: public CommonConceptGraph
         Hyperedges defineResource(const UniqueId& uid, const std::string& name="Resource", const Hyperedges& superResourceUids = Hyperedges{ResourceUid});
         // Instantiate a resource of a given amount
         Hyperedges instantiateResource(const Hyperedges& resourceClassUids, const float amount=0.f);
+        // Get/Set the amount of a resource instance
+        float amountOf(const UniqueId& resourceUid) const;
+        void amountOf(const UniqueId& resourceUid, const float amount);
+        // Get the amount of a provided resource instance which is already consumed by mapped consumers
+        float usageOf(const UniqueId& resourceUid) const;
+        // Get the (small, integer) id of a resource class in the ledger or -1 if it is unknown
+        int resourceClassIdOf(const UniqueId& resourceClassUid) const;
+        // Check if an available resource instance can serve a needed (or consumed) resource instance
+        bool compatible(const UniqueId& neededResourceUid, const UniqueId& availableResourceUid) const;
+        // (Re-)Builds the resource ledger from the resource instances and mappings of the graph
+        void indexResources();
 
         // Make something a consumer
         Hyperedges isConsumer(const Hyperedges& consumerUids);
@@ -119,15 +175,99 @@ class Model: public CommonConceptGraph
         Hyperedges consumersOf(const Hyperedges& providerUids) const;
         // Returns all providers to which consumerUids are mapped to
         Hyperedges providersOf(const Hyperedges& consumerUids) const;
+        // Maps consumers to providers (by MAPPED-TO or one of its subrelations) and books the consumed resources
+        Hyperedges mapTo(const Hyperedges& consumerUids, const Hyperedges& providerUids, const UniqueId& relationUid=Model::MappedToUid);
+        // Removes all mappings of consumers and releases the consumed resources. Returns the former providers.
+        Hyperedges unmap(const Hyperedges& consumerUids);
+        // Returns the amount of an available resource instance a consumer would consume if it were mapped to its provider
+        float consumedOf(const UniqueId& consumerUid, const UniqueId& availableResourceUid) const;
         // Check if a provider fullfills all resource needs of a consumer
         // Returns >= 0 if satisfiable and < 0 if not satisfiable
         float satisfies(const Hyperedges& providerUids, const Hyperedges& consumerUids) const;
 
+        // Packed mode
+        // Packs the resources of the given consumers and providers (see above)
+        void pack(const Hyperedges& consumerUids, const Hyperedges& providerUids);
+        void unpack();
+        bool isPacked() const;
+        const Hyperedges& packedConsumers() const;
+        const Hyperedges& packedProviders() const;
+        // Row stride of the provider matrices (number of packed providers padded to a multiple of 8)
+        std::size_t packedStride() const;
+        // Provider matrices: entry [resourceClassId * packedStride() + provider]
+        const std::vector< float >& capacities() const;
+        const std::vector< float >& residuals() const;
+        // Consumer matrix: entry [resourceClassId * packedConsumers().size() + consumer] (negative, if there is no demand)
+        const std::vector< float >& demands() const;
+        // Evaluates a packed consumer against all packed providers (same values as satisfies() unless negative)
+        // Returns false if the consumer has not been packed (or has demands of more than one resource class)
+        bool fits(const UniqueId& consumerUid, std::vector< float >& slack) const;
+        // Like satisfies(), but uses the precomputed scores or the packed matrices if possible (may be called by several threads at once)
+        float fits(const UniqueId& consumerUid, const UniqueId& providerUid) const;
+        // Precomputes the scores of all packed consumers and providers using the given number of threads
+        // NOTE: The scores of a provider are dropped as soon as its residuals change
+        void precompute(const unsigned int threads=1);
+
         // Advanced functions
+        // Signatures of the functions used for mapping (see CommonConceptGraph::map)
+        typedef Hyperedges (*PartitionFunc) (const ResourceCost::Model& rcm);
+        typedef float (*MatchFunc) (const ResourceCost::Model& rcm, const UniqueId& consumerUid, const UniqueId& providerUid);
+        typedef void (*MapFunc) (CommonConceptGraph& ccg, const UniqueId& consumerUid, const UniqueId& providerUid);
+        typedef bool (*EquivalenceFunc) (const ResourceCost::Model& rcm, const UniqueId& providerUidA, const UniqueId& providerUidB);
+        // Greedily maps every consumer of the left partition to the best matching provider of the right partition (if any)
+        // NOTE: In contrast to CommonConceptGraph::map, the functions operate on the resulting model itself. So no temporary model is constructed per call.
+        // NOTE: The resource scores of all pairs are precomputed by the given number of threads before the greedy assignment starts.
+        Model map (PartitionFunc partitionFuncLeft, PartitionFunc partitionFuncRight, MatchFunc matchFunc, MapFunc mapFunc, const unsigned int threads=1) const;
+        Model map (const Hyperedges& leftUids, const Hyperedges& rightUids, MatchFunc matchFunc, MapFunc mapFunc, const unsigned int threads=1) const;
+
         static Hyperedges partitionFuncLeft (const ResourceCost::Model& rcm);
         static Hyperedges partitionFuncRight (const ResourceCost::Model& rcm);
         static float matchFunc (const ResourceCost::Model& rcm, const UniqueId& consumerUid, const UniqueId& providerUid);
         static void mapFunc (CommonConceptGraph& ccg, const UniqueId& consumerUid, const UniqueId& providerUid); 
+        // Two providers are equivalent if they provide the same amounts of the same resources (and have the same usage)
+        static bool equivalentProviders (const ResourceCost::Model& rcm, const UniqueId& providerUidA, const UniqueId& providerUidB);
+
+    protected:
+        // Books (or releases if sign < 0) the resources consumed by a consumer at a provider
+        void book(const UniqueId& consumerUid, const UniqueId& providerUid, const float sign=1.f);
+        // Returns the slot of a resource instance in the ledger (creates it if necessary)
+        std::size_t slotOf(const UniqueId& resourceUid);
+        // Returns the id of a resource class in the ledger (creates it if necessary)
+        std::size_t registerResourceClass(const UniqueId& resourceClassUid);
+        // Returns the classes of a resource instance and all their superclasses (except of RESOURCE)
+        Hyperedges compatibleClassesOf(const UniqueId& resourceUid) const;
+        // Recomputes the residuals of a packed provider
+        void repack(const UniqueId& providerUid);
+
+        // Resource ledger
+        std::unordered_map< UniqueId, std::size_t > resourceSlots;
+        std::vector< float > resourceAmounts;
+        std::vector< float > resourceUsages;
+        // Resource class index: every resource class has an id and every resource instance has two bitsets of resourceClassWords words:
+        // the bits of its classes and the bits of its classes including their superclasses
+        std::unordered_map< UniqueId, std::size_t > resourceClassIds;
+        std::size_t resourceClassWords;
+        std::vector< std::uint64_t > resourceClassBits;
+        std::vector< std::uint64_t > resourceSuperclassBits;
+        // Packed mode
+        bool packedMode;
+        Hyperedges packedConsumerUids;
+        Hyperedges packedProviderUids;
+        std::unordered_map< UniqueId, std::size_t > packedConsumerColumns;
+        std::unordered_map< UniqueId, std::size_t > packedProviderColumns;
+        std::size_t packedRows;
+        std::size_t packedProviderStride;
+        std::vector< float > packedCapacities;
+        std::vector< float > packedResiduals;
+        std::vector< float > packedDemands;
+        std::vector< long > packedSlots;
+        std::vector< bool > packedConsumerValid;
+        // Precomputed scores: entry [consumer * packedProviders().size() + provider] (valid, if both consumer and provider are flagged)
+        std::vector< float > packedScores;
+        std::vector< char > packedScoredConsumers;
+        std::vector< char > packedScoredProviders;
+        // Identifies the current contents of the packed matrices (slack cached by fits() is only valid for the same stamp)
+        std::uint64_t packedStamp;
 };
 
 }
@@ -0,0 +1,238 @@
+#ifndef _RESOURCE_COST_SOLVER_HPP
+#define _RESOURCE_COST_SOLVER_HPP
+
+#include "ResourceCostModel.hpp"
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ResourceCost {
+
+/*
+    OBJECTIVE CLASS
+
+    The solvers map as many consumers as possible while leaving as many resources of the providers as possible.
+    An objective adds (non-negative) costs between pairs of neighbouring consumers which depend on the providers both are mapped to,
+    e.g. the traffic between two consumers times the distance between their providers.
+    The base class has no neighbours and thus no costs.
+
+    The costs are evaluated incrementally: Mapping a consumer to a provider costs the sum over its neighbours which are mapped already.
+    Every strategy minimizes these costs together with its own measure of the consumed resources (see the solvers below).
+*/
+
+class Objective {
+    public:
+        // Neighbours of a consumer and the providers they are mapped to
+        typedef std::vector< std::pair< UniqueId, UniqueId > > Placements;
+
+        virtual ~Objective();
+        // Returns the consumers which have costs with the given one (has to be symmetric)
+        virtual Hyperedges neighboursOf(const UniqueId& consumerUid) const;
+        // Returns the costs between two neighbouring consumers mapped to the given providers (has to be symmetric)
+        virtual double costsBetween(const UniqueId& consumerUidA, const UniqueId& providerUidA, const UniqueId& consumerUidB, const UniqueId& providerUidB) const;
+
+        // Returns the mapped neighbours of a consumer
+        Placements mappedNeighboursOf(const Model& rcm, const UniqueId& consumerUid) const;
+        // Returns the costs of mapping a consumer to a provider given its mapped neighbours
+        double costsOf(const UniqueId& consumerUid, const UniqueId& providerUid, const Placements& mappedNeighbours) const;
+        double costsOf(const Model& rcm, const UniqueId& consumerUid, const UniqueId& providerUid) const;
+        // Returns the costs of the current mapping of the given consumers (every pair of neighbours is counted once)
+        double costsOf(const Model& rcm, const Hyperedges& consumerUids) const;
+};
+
+/*
+    SOLVER CLASS
+
+    A solver assigns the consumers of a left partition to the providers of a right partition of a model.
+    It returns a copy of the model in which the assignments have been established by the given map function.
+    The match function decides if (>= 0) and how well (greater is better) a consumer matches a provider.
+
+    This base class implements the greedy strategy (see Model::map).
+    If an objective is given, its costs (see Objective::costsOf) are subtracted from the score of every valid match.
+    Other strategies can be plugged in by deriving from it.
+*/
+
+class Solver {
+    public:
+        virtual ~Solver();
+        virtual std::string name() const;
+        virtual Model solve(const Model& rcm,
+                            Model::PartitionFunc partitionFuncLeft,
+                            Model::PartitionFunc partitionFuncRight,
+                            Model::MatchFunc matchFunc,
+                            Model::MapFunc mapFunc,
+                            const unsigned int threads=1,
+                            const Objective& objective=Objective()) const;
+};
+
+/*
+    ASSIGNMENT SOLVER CLASS
+
+    This solver computes an optimal assignment by successive shortest paths on the flow network
+
+    SOURCE -- 1 --> CONSUMER -- 1 --> PROVIDER -- SLOTS --> SINK
+
+    A CONSUMER is connected to a PROVIDER iff they match on the unmapped model.
+    The costs of such an edge are the fractions of the resources of the PROVIDER the CONSUMER consumes.
+    Thus, a min-cost max-flow maps as many consumers as possible while leaving as many resources as possible.
+
+    The SLOTS of a PROVIDER (how many consumers it can host) depend on the mode:
+    * UNIT_CAPACITY: Every PROVIDER hosts at most one CONSUMER (Hungarian assignment).
+    * UNIFORM_DEMANDS: All CONSUMERS consume the same amounts (e.g. a single resource type).
+      Then the SLOTS follow from the residual resources of the PROVIDER.
+      If the demands are not uniform, the greedy strategy is used instead.
+
+    NOTE: Match functions may also depend on other mappings (e.g. reachability).
+    Therefore every assignment is checked again when it is established and consumers which fail are mapped greedily afterwards.
+    NOTE: The costs of an objective towards neighbours which are mapped already are added to the costs of an edge.
+    The costs between two consumers which are both assigned are not linear, so the flow network cannot express them directly.
+    If the objective has such costs, the flow is solved for at most the given number of rounds:
+    every round adds the costs towards the providers the neighbours got in the round before, while every other consumer keeps its provider.
+    The best round (like in the MultiStartSolver) is returned.
+*/
+
+class AssignmentSolver : public Solver {
+    public:
+        enum Mode {
+            UNIT_CAPACITY = 0,
+            UNIFORM_DEMANDS = 1
+        };
+
+        AssignmentSolver(const enum Mode& mode=UNIFORM_DEMANDS, const std::size_t rounds=8);
+
+        std::string name() const;
+        Model solve(const Model& rcm,
+                    Model::PartitionFunc partitionFuncLeft,
+                    Model::PartitionFunc partitionFuncRight,
+                    Model::MatchFunc matchFunc,
+                    Model::MapFunc mapFunc,
+                    const unsigned int threads=1,
+                    const Objective& objective=Objective()) const;
+
+    protected:
+        enum Mode solverMode;
+        std::size_t maxRounds;
+};
+
+/*
+    BRANCH AND BOUND SOLVER CLASS
+
+    This solver searches depth-first through all assignments of consumers to providers (or to no provider at all).
+    The match and map functions are applied to the model during the search, so all their rules (e.g. satisfies() or reachability) hold.
+    A solution is better, if it leaves fewer consumers unmapped or, for the same number, consumes smaller fractions of the provided resources plus smaller costs of the objective.
+    The costs of the objective are added when a consumer is mapped (its neighbours are mapped already or follow later).
+
+    The search starts with the greedy solution as incumbent and prunes a branch if
+    * the remaining consumers cannot be mapped better than the incumbent even if they took their cheapest providers, or
+    * the aggregated (normalized) residual capacity of all providers cannot host the remaining consumers.
+    Among equivalent providers (see equivalence function) which have not been used yet, only the first one is tried.
+
+    When the budget (wall-clock time in seconds) runs out, the best incumbent found so far is returned.
+*/
+
+class BranchAndBoundSolver : public Solver {
+    public:
+        BranchAndBoundSolver(const double budget=10.0, Model::EquivalenceFunc equivalenceFunc=Model::equivalentProviders);
+
+        std::string name() const;
+        Model solve(const Model& rcm,
+                    Model::PartitionFunc partitionFuncLeft,
+                    Model::PartitionFunc partitionFuncRight,
+                    Model::MatchFunc matchFunc,
+                    Model::MapFunc mapFunc,
+                    const unsigned int threads=1,
+                    const Objective& objective=Objective()) const;
+
+    protected:
+        double budgetInSeconds;
+        Model::EquivalenceFunc equivalent;
+};
+
+/*
+    ANNEALING SOLVER CLASS
+
+    This solver starts from the greedy solution and improves it by simulated annealing.
+    In every step, one mapped consumer is moved to another provider or two consumers swap their providers.
+    Unmapped consumers are moved to some provider.
+
+    The energy to be minimized is
+    * a penalty for every unmapped consumer plus
+    * the sum of the utilizations U of all provided resources (this is the linear objective of the Mapper) plus
+    * the sum of U^2 (which favours balanced providers over e.g. one at 95% and another one at 20%) plus
+    * the costs of the objective.
+    Because only the resources of the two involved providers and the costs between the involved consumers and their neighbours change, a step is evaluated incrementally.
+    Only accepted steps are checked by the match function and applied to the model (so satisfies() and reachability rules hold).
+
+    The search is reproducible for a given seed and stops after the given number of iterations or when the budget (wall-clock time in seconds) runs out.
+    Afterwards, the best solution found is established.
+*/
+
+class AnnealingSolver : public Solver {
+    public:
+        AnnealingSolver(const unsigned long seed=0, const std::size_t iterations=10000, const double budget=10.0);
+
+        std::string name() const;
+        Model solve(const Model& rcm,
+                    Model::PartitionFunc partitionFuncLeft,
+                    Model::PartitionFunc partitionFuncRight,
+                    Model::MatchFunc matchFunc,
+                    Model::MapFunc mapFunc,
+                    const unsigned int threads=1,
+                    const Objective& objective=Objective()) const;
+        // Improves the existing mapping of the consumers of the left partition in place
+        // Returns the reduction of the energy (see above)
+        double improve(Model& rcm,
+                       Model::PartitionFunc partitionFuncLeft,
+                       Model::PartitionFunc partitionFuncRight,
+                       Model::MatchFunc matchFunc,
+                       Model::MapFunc mapFunc,
+                       const Objective& objective=Objective()) const;
+
+    protected:
+        double improve(Model& rcm,
+                       const Hyperedges& leftUids,
+                       const Hyperedges& rightUids,
+                       Model::MatchFunc matchFunc,
+                       Model::MapFunc mapFunc,
+                       const Objective& objective) const;
+
+        unsigned long randomSeed;
+        std::size_t maxIterations;
+        double budgetInSeconds;
+};
+
+/*
+    MULTI START SOLVER CLASS
+
+    The result of the greedy strategy depends on the order of consumers and providers.
+    This solver runs several greedy passes with different orders (in parallel) and keeps the best result:
+    * Pass 0: The order of the partition functions
+    * Pass 1: Largest demands first
+    * Pass 2: Most constrained consumers (fewest matching providers) first
+    * Pass 3 and following: Random orders of consumers and providers
+
+    A result is better if it leaves fewer consumers unmapped or, for the same number, more (normalized) residual resources minus the costs of the objective.
+    For a given seed, the result does not depend on the number of threads.
+*/
+
+class MultiStartSolver : public Solver {
+    public:
+        MultiStartSolver(const std::size_t restarts=8, const unsigned long seed=0);
+
+        std::string name() const;
+        Model solve(const Model& rcm,
+                    Model::PartitionFunc partitionFuncLeft,
+                    Model::PartitionFunc partitionFuncRight,
+                    Model::MatchFunc matchFunc,
+                    Model::MapFunc mapFunc,
+                    const unsigned int threads=1,
+                    const Objective& objective=Objective()) const;
+
+    protected:
+        std::size_t numRestarts;
+        unsigned long randomSeed;
+};
+
+}
+
+#endif
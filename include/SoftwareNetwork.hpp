@@ -2,6 +2,12 @@
 #define _SOFTWARE_GRAPH_HPP
 
 #include "ComponentNetwork.hpp"
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <map>
+#include <memory>
+#include <vector>
 
 namespace Software {
 
@@ -121,9 +127,230 @@ class Network : public Component::Network
         Hyperedges realizes(const Hyperedges& implementationIds, const Hyperedges& algorithmIds);
 
         // Special function to find all possible implementation networks from an algorithm network
+        // NOTE: This holds all of them in memory. Use an ImplementationNetworks enumerator to get one after another instead.
         std::vector< Software::Network > generateAllImplementationNetworks() const;
 };
 
+class NetworkOverlay;
+
+/*
+    Every algorithm instance of an algorithm network can be realized by any implementation of its class.
+    So an implementation network is a number in a mixed radix system:
+    Digit i chooses one of the implementations of the i-th algorithm (and its radix is the number of these implementations).
+
+    An ImplementationNetworks enumerator only holds the algorithm network and a counter.
+    Every implementation network is built from the algorithm network when it is requested, so only one of them has to be in memory at a time.
+    An overlay of a variant (see NetworkOverlay) shares the algorithm network with the enumerator and all other overlays, so many of them can be kept at once.
+
+    The wiring of the algorithms is the same for every variant.
+    So it is compiled once into a plan of (algorithm, interfaces) -> (algorithm, interfaces) wires, which already holds the interfaces of every implementation class.
+    A variant is then wired by looking up the chosen implementations only (no queries by label).
+
+    Every variant can be built on its own, so forEach() builds them with several threads:
+    The index space is split evenly among the workers and a worker which runs out of indices steals the upper half of the remaining ones of another.
+    forEachInOrder() hands out the indices in ascending order instead, so the results waiting for their predecessors stay few.
+    The variants come in the order of generateAllImplementationNetworks (the first algorithm is the most significant digit).
+*/
+class ImplementationNetworks
+{
+    public:
+        ImplementationNetworks(const Network& algorithmNetwork);
+
+        // Returns the number of implementation networks (0 if some algorithm has no implementation at all; saturates at the largest std::size_t)
+        std::size_t size() const;
+        // Returns the index of the implementation chosen for every algorithm by the given variant
+        std::vector< std::size_t > choicesOf(const std::size_t index) const;
+        // Builds the given variant
+        Network at(const std::size_t index) const;
+        // Builds the given variant as a delta on the algorithm network
+        NetworkOverlay overlayAt(const std::size_t index) const;
+
+        // Builds the variants [first, last) with the given number of threads and hands each of them (with its index) to visit
+        // NOTE: visit is called concurrently and in no particular order
+        void forEach(const std::function< void (const std::size_t, const NetworkOverlay&) >& visit,
+                     const unsigned int threads = 1,
+                     const std::size_t first = 0,
+                     const std::size_t last = std::numeric_limits< std::size_t >::max()) const;
+        // Like forEach, but produce (e.g. scoring or serializing a variant) runs concurrently while consume gets the results one at a time in the order of the indices
+        // NOTE: Results which are ready before their predecessors are buffered (a few per thread at most, producers wait for the consumer)
+        void forEachInOrder(const std::function< std::string (const std::size_t, const NetworkOverlay&) >& produce,
+                            const std::function< void (const std::size_t, const std::string&) >& consume,
+                            const unsigned int threads = 1,
+                            const std::size_t first = 0,
+                            const std::size_t last = std::numeric_limits< std::size_t >::max()) const;
+        // Like above, but for the given variants only (in the order of the list)
+        void forEach(const std::function< void (const std::size_t, const NetworkOverlay&) >& visit,
+                     const unsigned int threads,
+                     const std::vector< std::size_t >& indices) const;
+        void forEachInOrder(const std::function< std::string (const std::size_t, const NetworkOverlay&) >& produce,
+                            const std::function< void (const std::size_t, const std::string&) >& consume,
+                            const unsigned int threads,
+                            const std::vector< std::size_t >& indices) const;
+
+        // Cursor: Builds the current variant and advances to the next one. Returns false if there is none left.
+        bool next(Network& variant);
+        // Returns the index of the variant next() builds next
+        std::size_t index() const;
+        void reset(const std::size_t index = 0);
+
+    protected:
+        // A DEPENDS-ON wire between the interfaces of two algorithms (given by index)
+        // NOTE: The interfaces are given per implementation class of the algorithm (as in implementationClassUids)
+        struct Wire
+        {
+            std::size_t inputAlgorithm;
+            std::size_t outputAlgorithm;
+            std::vector< Hyperedges > inputInterfaceUids;
+            std::vector< Hyperedges > outputInterfaceUids;
+        };
+
+        // Compiles the wiring plan
+        void compile();
+        // Connects the implementations like the algorithms they realize
+        void wire(NetworkOverlay& variant, const Hyperedges& implUids, const std::vector< std::size_t >& choices) const;
+
+        std::shared_ptr< const Network > algorithmNetwork;
+        Hyperedges algorithmUids;
+        std::vector< Hyperedges > implementationClassUids;
+        std::vector< Wire > wiring;
+        std::size_t numVariants;
+        std::size_t current;
+};
+
+/*
+    A NetworkView answers the queries of a Software::Network on a borrowed graph without copying it (see Component::NetworkView)
+*/
+class NetworkView : public Component::NetworkView
+{
+    public:
+        NetworkView(const CommonConceptGraph& ccg);
+        ~NetworkView();
+
+        // NOTE: Returns subclasses
+        Hyperedges algorithmClasses(const std::string& name="", const Hyperedges& suids=Hyperedges()) const;
+        Hyperedges interfaceClasses(const std::string& name="", const Hyperedges& suids=Hyperedges()) const;
+        Hyperedges implementationClasses(const std::string& name="", const Hyperedges& suids=Hyperedges()) const;
+        Hyperedges implementationInterfaceClasses(const std::string& name="", const Hyperedges& suids=Hyperedges()) const;
+
+        // NOTE: Returns instances
+        Hyperedges algorithms(const std::string& name="", const std::string& className="") const;
+        Hyperedges interfaces(const std::string& name="", const std::string& className="") const;
+        Hyperedges implementations(const std::string& name="", const std::string& className="") const;
+        Hyperedges implementationInterfaces(const std::string& name="", const std::string& className="") const;
+
+        // Special additional queries
+        Hyperedges inputsOf(const Hyperedges& uids, const std::string& name="", const Hypergraph::TraversalDirection dir=Hypergraph::FORWARD) const;
+        Hyperedges outputsOf(const Hyperedges& uids, const std::string& name="", const Hypergraph::TraversalDirection dir=Hypergraph::FORWARD) const;
+        Hyperedges implementationsOf(const Hyperedges& uids, const std::string& name="", const Hypergraph::TraversalDirection dir=Hypergraph::INVERSE) const;
+        Hyperedges encodersOf(const Hyperedges& uids, const std::string& name="", const Hypergraph::TraversalDirection dir=Hypergraph::INVERSE) const;
+        Hyperedges realizersOf(const Hyperedges& uids, const std::string& name="", const Hypergraph::TraversalDirection dir=Hypergraph::INVERSE) const;
+};
+
+/*
+    A NetworkOverlay answers the queries of a Software::NetworkView on an immutable (shared) base network plus what has been added to (or removed from) it.
+    It is not a Software::Network itself: it only mirrors the query API, so code which needs a Hypergraph has to flatten() the overlay first.
+
+    The implementation networks of an algorithm network differ from it by a few implementation instances (and their interfaces), REALIZES and DEPENDS-ON facts only.
+    So an overlay of such a variant costs its delta instead of a full copy of the base.
+    The delta consists of
+    * new individuals (uid, label and classes),
+    * new facts of a relation or copies of the facts between two concepts of the base (like instantiateComponent copies the facts of a class) and
+    * hidden individuals of the base.
+    The uids of new individuals are derived from the uids of the base (e.g. <algorithm>/<implementation class>), so the same variant always gets the same uids.
+
+    The queries of a Software::NetworkView are answered on the union of base and delta, so consumers can use an overlay without flattening it.
+    apply() adds the delta to a graph which already contains the base (e.g. a Mapper) and flatten() returns the equivalent Software::Network.
+    NOTE: Classes and relations cannot be added, so the class queries are answered by the base alone.
+*/
+class NetworkOverlay
+{
+    public:
+        NetworkOverlay(const std::shared_ptr< const Network >& base);
+        ~NetworkOverlay();
+
+        const Network& base() const;
+
+        // Delta
+        // Instantiates an implementation class (see instantiateComponent) which realizes an algorithm of the base. Returns the implementation instance.
+        Hyperedges realize(const UniqueId& implementationClassUid, const UniqueId& algorithmUid);
+        // See Network::dependsOn (NOTE: The facts of the delta have no uids)
+        void dependsOn(const Hyperedges& inputIds, const Hyperedges& outputIds);
+        // Adds facts of a relation without any checks (see CommonConceptGraph::factFrom)
+        void factFrom(const Hyperedges& fromIds, const Hyperedges& toIds, const UniqueId& relUid);
+        // Returns the uid of the clone of a descendant of the class of an instance created by realize()
+        static UniqueId cloneOf(const UniqueId& instanceUid, const UniqueId& descendantUid);
+        // Removes individuals of the delta (and their facts) and hides individuals of the base
+        void remove(const Hyperedges& uids);
+        // Returns the number of new individuals, new facts and hidden individuals
+        std::size_t deltaSize() const;
+
+        // Adds the delta to a graph which already contains the base
+        void apply(CommonConceptGraph& ccg) const;
+        // Returns a copy of the base with the delta applied
+        Network flatten() const;
+
+        // Access to individuals of base and delta
+        bool exists(const UniqueId& uid) const;
+        const Hyperedge& access(const UniqueId& uid) const;
+
+        // Generic queries on base and delta (see CommonConceptGraph)
+        Hyperedges instancesOf(const Hyperedges& uids, const std::string& name="", const Hypergraph::TraversalDirection dir=Hypergraph::INVERSE) const;
+        Hyperedges relatedTo(const Hyperedges& uids, const Hyperedges& relUids, const std::string& name="", const Hypergraph::TraversalDirection dir=Hypergraph::FORWARD) const;
+
+        // NOTE: Returns subclasses
+        Hyperedges algorithmClasses(const std::string& name="", const Hyperedges& suids=Hyperedges()) const;
+        Hyperedges interfaceClasses(const std::string& name="", const Hyperedges& suids=Hyperedges()) const;
+        Hyperedges implementationClasses(const std::string& name="", const Hyperedges& suids=Hyperedges()) const;
+        Hyperedges implementationInterfaceClasses(const std::string& name="", const Hyperedges& suids=Hyperedges()) const;
+
+        // NOTE: Returns instances
+        Hyperedges components(const std::string& name="", const std::string& className="") const;
+        Hyperedges algorithms(const std::string& name="", const std::string& className="") const;
+        Hyperedges interfaces(const std::string& name="", const std::string& className="") const;
+        Hyperedges implementations(const std::string& name="", const std::string& className="") const;
+        Hyperedges implementationInterfaces(const std::string& name="", const std::string& className="") const;
+
+        // Component queries
+        Hyperedges interfacesOf(const Hyperedges& uids, const std::string& name="", const Hypergraph::TraversalDirection dir=Hypergraph::FORWARD) const;
+        Hyperedges subinterfacesOf(const Hyperedges& uids, const std::string& name="", const Hypergraph::TraversalDirection dir=Hypergraph::FORWARD) const;
+        Hyperedges endpointsOf(const Hyperedges& uids, const std::string& name="", const Hypergraph::TraversalDirection dir=Hypergraph::FORWARD) const;
+
+        // Special additional queries
+        Hyperedges inputsOf(const Hyperedges& uids, const std::string& name="", const Hypergraph::TraversalDirection dir=Hypergraph::FORWARD) const;
+        Hyperedges outputsOf(const Hyperedges& uids, const std::string& name="", const Hypergraph::TraversalDirection dir=Hypergraph::FORWARD) const;
+        Hyperedges implementationsOf(const Hyperedges& uids, const std::string& name="", const Hypergraph::TraversalDirection dir=Hypergraph::INVERSE) const;
+        Hyperedges encodersOf(const Hyperedges& uids, const std::string& name="", const Hypergraph::TraversalDirection dir=Hypergraph::INVERSE) const;
+        Hyperedges realizersOf(const Hyperedges& uids, const std::string& name="", const Hypergraph::TraversalDirection dir=Hypergraph::INVERSE) const;
+
+    protected:
+        struct Individual
+        {
+            Hyperedge edge;
+            Hyperedges classUids;
+        };
+        // A fact of a relation or (if relationUid is empty) copies of the facts from templateFromUid to templateToUid in the base
+        struct Fact
+        {
+            UniqueId fromUid;
+            UniqueId toUid;
+            UniqueId relationUid;
+            UniqueId templateFromUid;
+            UniqueId templateToUid;
+        };
+
+        // Adds an individual to the delta (unless it exists already)
+        void individual(const UniqueId& uid, const std::string& label, const Hyperedges& classUids);
+        // Returns true if the fact is one of the given relations (and their subrelations)
+        bool isOneOf(const Fact& fact, const Hyperedges& relationUids) const;
+        bool matches(const UniqueId& uid, const std::string& name) const;
+        Hyperedges visible(const Hyperedges& uids) const;
+
+        std::shared_ptr< const Network > baseNetwork;
+        std::map< UniqueId, Individual > individuals;
+        std::vector< Fact > facts;
+        Hyperedges hiddenUids;
+};
+
 }
 
 #endif
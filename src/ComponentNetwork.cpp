@@ -54,14 +54,12 @@ Hyperedges Network::createInterface(const UniqueId& uid, const std::string& name
 
 Hyperedges Network::componentClasses(const std::string& name, const Hyperedges& suids) const
 {
-    Hyperedges all(subclassesOf(Hyperedges{Network::ComponentId}, name));
-    return intersect(all, subclassesOf(suids, name));
+    return NetworkView(*this).componentClasses(name, suids);
 }
 
 Hyperedges Network::interfaceClasses(const std::string& name, const Hyperedges& suids) const
 {
-    Hyperedges all(subclassesOf(Hyperedges{Network::InterfaceId}, name));
-    return intersect(all, subclassesOf(suids, name));
+    return NetworkView(*this).interfaceClasses(name, suids);
 }
 
 Hyperedges Network::instantiateComponent(const Hyperedges& componentIds, const std::string& newName)
@@ -120,18 +118,12 @@ Hyperedges Network::instantiateInterfaceFor(const Hyperedges& componentIds, cons
 
 Hyperedges Network::components(const std::string& name, const std::string& className) const
 {
-    // Get all super classes
-    const Hyperedges classIds(componentClasses(className));
-    // ... and then the instances of them
-    return instancesOf(classIds, name);
+    return NetworkView(*this).components(name, className);
 }
 
 Hyperedges Network::interfaces(const std::string& name, const std::string& className) const
 {
-    // Get all super classes
-    const Hyperedges& classIds(interfaceClasses(className));
-    // ... and then the instances of them
-    return instancesOf(classIds, name);
+    return NetworkView(*this).interfaces(name, className);
 }
 
 Hyperedges Network::aliasOf(const Hyperedges& aliasInterfaceUids, const Hyperedges& originalInterfaceUids)
@@ -165,7 +157,7 @@ Hyperedges Network::instantiateAliasInterfaceFor(const Hyperedges& parentUids, c
 
 Hyperedges Network::originalInterfacesOf(const Hyperedges& uids, const std::string& name, const TraversalDirection dir) const
 {
-    return CommonConceptGraph::relatedTo(uids, Hyperedges{Network::AliasOfId}, name, dir);
+    return NetworkView(*this).originalInterfacesOf(uids, name, dir);
 }
 
 
@@ -201,7 +193,7 @@ Hyperedges Network::connectInterface(const Hyperedges& fromInterfaceIds, const H
 
 Hyperedges Network::interfacesOf(const Hyperedges& uids, const std::string& name, const TraversalDirection dir) const
 {
-    return CommonConceptGraph::relatedTo(uids, Hyperedges{Network::HasAInterfaceId}, name, dir);
+    return NetworkView(*this).interfacesOf(uids, name, dir);
 }
 
 Hyperedges Network::partOfComponent(const Hyperedges& componentIds, const Hyperedges& compositeComponentIds)
@@ -236,12 +228,85 @@ Hyperedges Network::hasSubInterface(const Hyperedges& interfaceIds, const Hypere
 
 Hyperedges Network::subinterfacesOf(const Hyperedges& uids, const std::string& name, const TraversalDirection dir) const
 {
-    return CommonConceptGraph::relatedTo(uids, Hyperedges{Network::HasASubInterfaceId}, name, dir);
+    return NetworkView(*this).subinterfacesOf(uids, name, dir);
 }
 
 Hyperedges Network::subcomponentsOf(const Hyperedges& uids, const std::string& name, const TraversalDirection dir) const
 {
-    return CommonConceptGraph::relatedTo(uids, Hyperedges{Network::PartOfComponentId}, name, dir);
+    return NetworkView(*this).subcomponentsOf(uids, name, dir);
+}
+
+// NetworkView
+NetworkView::NetworkView(const CommonConceptGraph& ccg)
+: ccg(ccg)
+{
+}
+
+NetworkView::~NetworkView()
+{
+}
+
+const CommonConceptGraph& NetworkView::graph() const
+{
+    return ccg;
+}
+
+const Hyperedge& NetworkView::access(const UniqueId& uid) const
+{
+    return ccg.access(uid);
+}
+
+Hyperedges NetworkView::componentClasses(const std::string& name, const Hyperedges& suids) const
+{
+    const Hyperedges& all(ccg.subclassesOf(Hyperedges{Network::ComponentId}, name));
+    return intersect(all, ccg.subclassesOf(suids, name));
+}
+
+Hyperedges NetworkView::interfaceClasses(const std::string& name, const Hyperedges& suids) const
+{
+    const Hyperedges& all(ccg.subclassesOf(Hyperedges{Network::InterfaceId}, name));
+    return intersect(all, ccg.subclassesOf(suids, name));
+}
+
+Hyperedges NetworkView::components(const std::string& name, const std::string& className) const
+{
+    // Get all super classes
+    const Hyperedges& classIds(componentClasses(className));
+    // ... and then the instances of them
+    return ccg.instancesOf(classIds, name);
+}
+
+Hyperedges NetworkView::interfaces(const std::string& name, const std::string& className) const
+{
+    // Get all super classes
+    const Hyperedges& classIds(interfaceClasses(className));
+    // ... and then the instances of them
+    return ccg.instancesOf(classIds, name);
+}
+
+Hyperedges NetworkView::interfacesOf(const Hyperedges& uids, const std::string& name, const Hypergraph::TraversalDirection dir) const
+{
+    return ccg.relatedTo(uids, Hyperedges{Network::HasAInterfaceId}, name, dir);
+}
+
+Hyperedges NetworkView::originalInterfacesOf(const Hyperedges& uids, const std::string& name, const Hypergraph::TraversalDirection dir) const
+{
+    return ccg.relatedTo(uids, Hyperedges{Network::AliasOfId}, name, dir);
+}
+
+Hyperedges NetworkView::subinterfacesOf(const Hyperedges& uids, const std::string& name, const Hypergraph::TraversalDirection dir) const
+{
+    return ccg.relatedTo(uids, Hyperedges{Network::HasASubInterfaceId}, name, dir);
+}
+
+Hyperedges NetworkView::subcomponentsOf(const Hyperedges& uids, const std::string& name, const Hypergraph::TraversalDirection dir) const
+{
+    return ccg.relatedTo(uids, Hyperedges{Network::PartOfComponentId}, name, dir);
+}
+
+Hyperedges NetworkView::endpointsOf(const Hyperedges& uids, const std::string& name, const Hypergraph::TraversalDirection dir) const
+{
+    return ccg.endpointsOf(uids, name, dir);
 }
 
 
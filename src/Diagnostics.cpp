@@ -0,0 +1,127 @@
+#include "Diagnostics.hpp"
+#include <algorithm>
+#include <iostream>
+#include <mutex>
+
+namespace Diagnostics {
+
+std::atomic< int > currentLevel(INFO);
+std::atomic< bool > countingEnabled(false);
+std::atomic< unsigned long > counters[NUM_RULES];
+
+static std::ostream* currentSink(&std::cout);
+// Messages may be reported by several threads (e.g. while precomputing)
+static std::mutex sinkMutex;
+
+static const char* ruleNames[NUM_RULES] = {
+    "sat-insufficient",
+    "sat-no-resources",
+    "partition-internal-interface",
+    "reach-unknown-interface",
+    "reach-owner-not-mapped",
+    "reach-owner-mismatch",
+    "reach-endpoints-unreachable",
+    "reach-endpoint-owners-unmapped",
+    "reach-endpoint-owners-mismatch",
+    "reach-neighbours-unreachable",
+    "bandwidth-link-oversubscribed",
+    "completeness-no-provider"
+};
+
+Level level()
+{
+    return static_cast< Level >(currentLevel.load(std::memory_order_relaxed));
+}
+
+void level(const Level l)
+{
+    currentLevel.store(l, std::memory_order_relaxed);
+}
+
+bool counting()
+{
+    return countingEnabled.load(std::memory_order_relaxed);
+}
+
+void counting(const bool enabled)
+{
+    countingEnabled.store(enabled, std::memory_order_relaxed);
+}
+
+std::ostream& sink()
+{
+    return *currentSink;
+}
+
+void sink(std::ostream& os)
+{
+    std::lock_guard< std::mutex > lock(sinkMutex);
+    currentSink = &os;
+}
+
+void write(const Level l, const std::string& message)
+{
+    if (!enabled(l))
+        return;
+    std::lock_guard< std::mutex > lock(sinkMutex);
+    *currentSink << message << "\n";
+}
+
+const char* nameOf(const Rule rule)
+{
+    return ((rule >= 0) && (rule < NUM_RULES)) ? ruleNames[rule] : "unknown";
+}
+
+unsigned long countOf(const Rule rule)
+{
+    return counters[rule].load(std::memory_order_relaxed);
+}
+
+unsigned long totalCount()
+{
+    unsigned long total(0);
+    for (int rule = 0; rule < NUM_RULES; ++rule)
+        total += countOf(static_cast< Rule >(rule));
+    return total;
+}
+
+void reset()
+{
+    for (std::atomic< unsigned long >& counter : counters)
+        counter.store(0, std::memory_order_relaxed);
+}
+
+void summary(std::ostream& os)
+{
+    // Scale the bars to the largest counter
+    const std::size_t width(40);
+    unsigned long largest(0);
+    std::size_t nameWidth(0);
+    for (int rule = 0; rule < NUM_RULES; ++rule)
+    {
+        largest = std::max(largest, countOf(static_cast< Rule >(rule)));
+        nameWidth = std::max(nameWidth, std::string(ruleNames[rule]).size());
+    }
+    os << "REJECTIONS: " << totalCount() << "\n";
+    for (int rule = 0; rule < NUM_RULES; ++rule)
+    {
+        const unsigned long n(countOf(static_cast< Rule >(rule)));
+        if (!n)
+            continue;
+        const std::string name(ruleNames[rule]);
+        os << "  " << name << std::string(nameWidth - name.size(), ' ') << "\t" << n << "\t" << std::string(std::max< std::size_t >(1, n * width / largest), '#') << "\n";
+    }
+}
+
+void json(std::ostream& os)
+{
+    os << "{\n";
+    os << "  \"total\": " << totalCount() << ",\n";
+    os << "  \"rejections\": {";
+    for (int rule = 0; rule < NUM_RULES; ++rule)
+        os << (rule ? "," : "") << "\n    \"" << ruleNames[rule] << "\": " << countOf(static_cast< Rule >(rule));
+    os << "\n  }\n";
+    os << "}\n";
+}
+
+}
@@ -286,7 +286,7 @@ Hyperedges Generator::generateImplementationClassFor(const UniqueId& algorithmCl
     // Define a prefix (used later)
     std::string prefix("");
     auto cf = [&](const Conceptgraph& cg, const UniqueId& c, const Hyperedges& p) -> bool {
-        const Component::Network& cn(static_cast<const Component::Network&>(cg));
+        const Component::NetworkView cn(static_cast<const CommonConceptGraph&>(cg));
         // Check if interface has subinterfaces
         const Hyperedges& subUids(cn.subinterfacesOf(Hyperedges{c}));
         if (subUids.empty())
@@ -306,10 +306,10 @@ Hyperedges Generator::generateImplementationClassFor(const UniqueId& algorithmCl
         return false;
     };
     auto rf = [](const Conceptgraph& cg, const UniqueId& c, const UniqueId& r) -> bool {
-        const Component::Network& cn(static_cast<const Component::Network&>(cg));
+        const CommonConceptGraph& ccg(static_cast<const CommonConceptGraph&>(cg));
         // Check r <- FACT-OF -> subrelationsOf(HasASubInterfaceId)
-        const Hyperedges& toSearch(cn.isPointingTo(cn.relationsFrom(Hyperedges{r}, cn.access(CommonConceptGraph::FactOfId).label())));
-        if (intersect(toSearch, cn.subrelationsOf(Hyperedges{Component::Network::HasASubInterfaceId})).empty())
+        const Hyperedges& toSearch(ccg.isPointingTo(ccg.relationsFrom(Hyperedges{r}, ccg.access(CommonConceptGraph::FactOfId).label())));
+        if (intersect(toSearch, ccg.subrelationsOf(Hyperedges{Component::Network::HasASubInterfaceId})).empty())
             return false;
         return true;
     };
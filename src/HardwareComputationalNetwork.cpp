@@ -37,23 +37,19 @@ Network::~Network()
 
 Hyperedges Network::processorClasses(const std::string& name, const Hyperedges& suids) const
 {
-    const Hyperedges& all(componentClasses(name, Hyperedges{Network::ProcessorId}));
-    return suids.empty() ? all : intersect(all, subclassesOf(suids, name));
+    return NetworkView(*this).processorClasses(name, suids);
 }
 
 Hyperedges Network::deviceClasses(const std::string& name, const Hyperedges& suids) const
 {
-    const Hyperedges& all(componentClasses(name, Hyperedges{Network::DeviceId}));
-    return suids.empty() ? all : intersect(all, subclassesOf(suids, name));
+    return NetworkView(*this).deviceClasses(name, suids);
 }
 
 Hyperedges Network::interfaceClasses(const std::string& name, const Hyperedges& suids) const
 {
-    const Hyperedges& all(Component::Network::interfaceClasses(name, Hyperedges{Network::InterfaceId}));
-    return suids.empty() ? all : intersect(all, subclassesOf(suids, name));
+    return NetworkView(*this).interfaceClasses(name, suids);
 }
 
-
 Hyperedges Network::createProcessor(const UniqueId& uid, const std::string& name, const Hyperedges& suids)
 {
     return createComponent(uid, name, suids.empty() ? Hyperedges{Network::ProcessorId} : intersect(processorClasses(), suids));
@@ -70,27 +66,70 @@ Hyperedges Network::createInterface(const UniqueId& uid, const std::string& name
 }
 
 Hyperedges Network::devices(const std::string& name, const std::string& className) const
+{
+    return NetworkView(*this).devices(name, className);
+}
+
+Hyperedges Network::processors(const std::string& name, const std::string& className) const
+{
+    return NetworkView(*this).processors(name, className);
+}
+
+Hyperedges Network::interfaces(const Hyperedges& deviceIds, const std::string& name, const std::string& className) const
+{
+    return NetworkView(*this).interfaces(deviceIds, name, className);
+}
+
+// NetworkView
+NetworkView::NetworkView(const CommonConceptGraph& ccg)
+: Component::NetworkView(ccg)
+{
+}
+
+NetworkView::~NetworkView()
+{
+}
+
+Hyperedges NetworkView::processorClasses(const std::string& name, const Hyperedges& suids) const
+{
+    const Hyperedges& all(componentClasses(name, Hyperedges{Network::ProcessorId}));
+    return suids.empty() ? all : intersect(all, ccg.subclassesOf(suids, name));
+}
+
+Hyperedges NetworkView::deviceClasses(const std::string& name, const Hyperedges& suids) const
+{
+    const Hyperedges& all(componentClasses(name, Hyperedges{Network::DeviceId}));
+    return suids.empty() ? all : intersect(all, ccg.subclassesOf(suids, name));
+}
+
+Hyperedges NetworkView::interfaceClasses(const std::string& name, const Hyperedges& suids) const
+{
+    const Hyperedges& all(Component::NetworkView::interfaceClasses(name, Hyperedges{Network::InterfaceId}));
+    return suids.empty() ? all : intersect(all, ccg.subclassesOf(suids, name));
+}
+
+Hyperedges NetworkView::devices(const std::string& name, const std::string& className) const
 {
     // Get all device classes
     const Hyperedges& classIds(deviceClasses(className));
     // ... and return all instances of them
-    return instancesOf(classIds, name);
+    return ccg.instancesOf(classIds, name);
 }
 
-Hyperedges Network::processors(const std::string& name, const std::string& className) const
+Hyperedges NetworkView::processors(const std::string& name, const std::string& className) const
 {
     // Get all processor classes
     const Hyperedges& classIds(processorClasses(className));
     // ... and return all instances of them
-    return instancesOf(classIds, name);
+    return ccg.instancesOf(classIds, name);
 }
 
-Hyperedges Network::interfaces(const Hyperedges& deviceIds, const std::string& name, const std::string& className) const
+Hyperedges NetworkView::interfaces(const Hyperedges& deviceIds, const std::string& name, const std::string& className) const
 {
     // Get all interfaceClasses
     const Hyperedges& classIds(interfaceClasses(className));
     // ... get the instances with the given name
-    Hyperedges result(instancesOf(classIds, name));
+    Hyperedges result(ccg.instancesOf(classIds, name));
     if (deviceIds.size())
     {
         result = intersect(result, interfacesOf(deviceIds, name));
@@ -1,236 +1,2076 @@
 #include "Mapper.hpp"
+#include "Diagnostics.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <sstream>
+#include <thread>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 namespace Software
 {
 namespace Hardware
 {
 
+const unsigned int Reachability::Unreachable(std::numeric_limits< unsigned int >::max());
+
+Reachability::Reachability(const ResourceCost::Model& rcm, const unsigned int maxHops)
+: hopLimit(maxHops), routingWidth(0)
+{
+    const Software::NetworkView sw(rcm);
+    const ::Hardware::Computational::NetworkView hw(rcm);
+    index(sw, sw.implementations());
+    // Route between all hw components
+    route(index(hw, hw.devices()));
+}
+
+std::size_t Reachability::nodeOf(const UniqueId& uid)
+{
+    std::unordered_map< UniqueId, std::size_t >::const_iterator it(indices.find(uid));
+    if (it != indices.end())
+        return it->second;
+    const std::size_t node(uids.size());
+    uids.push_back(uid);
+    indices[uid] = node;
+    owners.push_back(std::vector< std::size_t >());
+    adjacentInterfaces.push_back(std::vector< std::size_t >());
+    adjacentOwners.push_back(std::vector< std::size_t >());
+    adjacentComponents.push_back(std::vector< std::size_t >());
+    return node;
+}
+
+std::vector< std::size_t > Reachability::index(const Component::NetworkView& net, const Hyperedges& componentUids)
+{
+    // Index the components, their interfaces and everything connected to them.
+    // Components which are only connected to the given ones (e.g. switches) are indexed as well, so we can route through them
+    std::vector< std::size_t > componentNodes;
+    Hyperedges pendingUids(componentUids);
+    std::unordered_map< UniqueId, bool > visited;
+    while (!pendingUids.empty())
+    {
+        const UniqueId componentUid(pendingUids.back());
+        pendingUids.pop_back();
+        if (visited[componentUid])
+            continue;
+        visited[componentUid] = true;
+        const std::size_t componentNode(nodeOf(componentUid));
+        componentNodes.push_back(componentNode);
+        for (const UniqueId& interfaceUid : net.interfacesOf(Hyperedges{componentUid}))
+        {
+            const std::size_t interfaceNode(nodeOf(interfaceUid));
+            // NOTE: nodeOf() may grow the tables, so it has to be called before accessing them
+            for (const UniqueId& ownerUid : net.interfacesOf(Hyperedges{interfaceUid},"",Hypergraph::TraversalDirection::INVERSE))
+            {
+                const std::size_t ownerNode(nodeOf(ownerUid));
+                owners[interfaceNode].push_back(ownerNode);
+            }
+            for (const UniqueId& endpointUid : net.endpointsOf(Hyperedges{interfaceUid},"",Hypergraph::TraversalDirection::BOTH))
+            {
+                const std::size_t endpointNode(nodeOf(endpointUid));
+                adjacentInterfaces[interfaceNode].push_back(endpointNode);
+                for (const UniqueId& ownerUid : net.interfacesOf(Hyperedges{endpointUid},"",Hypergraph::TraversalDirection::INVERSE))
+                {
+                    const std::size_t ownerNode(nodeOf(ownerUid));
+                    adjacentOwners[interfaceNode].push_back(ownerNode);
+                    adjacentComponents[componentNode].push_back(ownerNode);
+                    componentLinks.insert(std::make_pair(std::make_pair(componentNode, ownerNode), Link(std::min(interfaceNode, endpointNode), std::max(interfaceNode, endpointNode))));
+                    pendingUids.push_back(ownerUid);
+                }
+            }
+        }
+    }
+    // Sort everything for lookups
+    for (std::vector< std::vector< std::size_t > >* table : {&owners, &adjacentInterfaces, &adjacentOwners, &adjacentComponents})
+    {
+        for (std::vector< std::size_t >& nodes : *table)
+        {
+            std::sort(nodes.begin(), nodes.end());
+            nodes.erase(std::unique(nodes.begin(), nodes.end()), nodes.end());
+        }
+    }
+    return componentNodes;
+}
+
+void Reachability::route(const std::vector< std::size_t >& componentNodes)
+{
+    const std::size_t n(componentNodes.size());
+    routingWidth = n;
+    routedNodes = componentNodes;
+    routingSlots.assign(uids.size(), -1);
+    for (std::size_t slot = 0; slot < n; ++slot)
+        routingSlots[componentNodes[slot]] = static_cast< int >(slot);
+    // Breadth-first search from every component
+    hops.assign(n * n, Unreachable);
+    predecessors.assign(n * n, -1);
+    std::vector< std::size_t > queue;
+    for (std::size_t source = 0; source < n; ++source)
+    {
+        unsigned int* distances(&hops[source * n]);
+        int* previous(&predecessors[source * n]);
+        distances[source] = 0;
+        queue.assign(1, componentNodes[source]);
+        for (std::size_t head = 0; head < queue.size(); ++head)
+        {
+            const std::size_t node(queue[head]);
+            const unsigned int distance(distances[routingSlots[node]]);
+            for (const std::size_t neighbourNode : adjacentComponents[node])
+            {
+                const int slot(routingSlots[neighbourNode]);
+                if ((slot < 0) || (distances[slot] != Unreachable))
+                    continue;
+                distances[slot] = distance + 1;
+                previous[slot] = routingSlots[node];
+                queue.push_back(neighbourNode);
+            }
+        }
+    }
+}
+
+int Reachability::indexOf(const UniqueId& uid) const
+{
+    std::unordered_map< UniqueId, std::size_t >::const_iterator it(indices.find(uid));
+    return (it != indices.end()) ? static_cast< int >(it->second) : -1;
+}
+
+Hyperedges Reachability::uidsOf(const std::vector< std::size_t >& nodes) const
+{
+    Hyperedges result;
+    result.reserve(nodes.size());
+    for (const std::size_t node : nodes)
+        result.push_back(uids[node]);
+    return result;
+}
+
+bool Reachability::contains(const std::vector< std::size_t >& nodes, const UniqueId& uid) const
+{
+    const int node(indexOf(uid));
+    return (node >= 0) && std::binary_search(nodes.begin(), nodes.end(), static_cast< std::size_t >(node));
+}
+
+const std::vector< std::size_t >& Reachability::ownersOf(const std::size_t node) const
+{
+    return owners[node];
+}
+
+const std::vector< std::size_t >& Reachability::adjacentInterfacesOf(const std::size_t node) const
+{
+    return adjacentInterfaces[node];
+}
+
+const std::vector< std::size_t >& Reachability::adjacentOwnersOf(const std::size_t node) const
+{
+    return adjacentOwners[node];
+}
+
+const std::vector< std::size_t >& Reachability::adjacentComponentsOf(const std::size_t node) const
+{
+    return adjacentComponents[node];
+}
+
+unsigned int Reachability::maxHops() const
+{
+    return hopLimit;
+}
+
+unsigned int Reachability::hopsBetween(const std::size_t componentNodeA, const std::size_t componentNodeB) const
+{
+    if ((componentNodeA >= routingSlots.size()) || (componentNodeB >= routingSlots.size()))
+        return Unreachable;
+    const int slotA(routingSlots[componentNodeA]);
+    const int slotB(routingSlots[componentNodeB]);
+    if ((slotA < 0) || (slotB < 0))
+        return (componentNodeA == componentNodeB) ? 0 : Unreachable;
+    return hops[slotA * routingWidth + slotB];
+}
+
+unsigned int Reachability::hopsFrom(const std::size_t interfaceNode, const std::size_t componentNode) const
+{
+    // Leave through the link of the interface and continue from the component on the other side
+    unsigned int best(Unreachable);
+    for (const std::size_t ownerNode : adjacentOwners[interfaceNode])
+    {
+        const unsigned int distance(hopsBetween(ownerNode, componentNode));
+        if (distance < best - 1)
+            best = distance + 1;
+    }
+    return best;
+}
+
+unsigned int Reachability::hopsVia(const std::size_t interfaceNodeA, const std::size_t interfaceNodeB) const
+{
+    // Directly linked interfaces
+    if (std::binary_search(adjacentInterfaces[interfaceNodeA].begin(), adjacentInterfaces[interfaceNodeA].end(), interfaceNodeB))
+        return 1;
+    // Otherwise leave through the link of A, route to a component linked to B and arrive through the link of B
+    unsigned int best(Unreachable);
+    for (const std::size_t ownerNode : adjacentOwners[interfaceNodeB])
+    {
+        const unsigned int distance(hopsFrom(interfaceNodeA, ownerNode));
+        if (distance < best - 1)
+            best = distance + 1;
+    }
+    return best;
+}
+
+std::vector< Reachability::Link > Reachability::linksVia(const std::size_t interfaceNodeA, const std::size_t interfaceNodeB) const
+{
+    std::vector< Link > result;
+    // Directly linked interfaces
+    if (std::binary_search(adjacentInterfaces[interfaceNodeA].begin(), adjacentInterfaces[interfaceNodeA].end(), interfaceNodeB))
+    {
+        result.push_back(Link(std::min(interfaceNodeA, interfaceNodeB), std::max(interfaceNodeA, interfaceNodeB)));
+        return result;
+    }
+    // Otherwise find the shortest route: A -> N (owner of an interface linked to A) -> ... -> M (owner of an interface linked to B) -> B
+    unsigned int best(Unreachable);
+    std::size_t firstInterfaceNode(0), firstComponentNode(0), lastInterfaceNode(0), lastComponentNode(0);
+    for (const std::size_t n : adjacentInterfaces[interfaceNodeA])
+    {
+        for (const std::size_t firstNode : owners[n])
+        {
+            for (const std::size_t m : adjacentInterfaces[interfaceNodeB])
+            {
+                for (const std::size_t lastNode : owners[m])
+                {
+                    const unsigned int distance(hopsBetween(firstNode, lastNode));
+                    if ((distance == Unreachable) || (distance + 2 >= best))
+                        continue;
+                    best = distance + 2;
+                    firstInterfaceNode = n;
+                    firstComponentNode = firstNode;
+                    lastInterfaceNode = m;
+                    lastComponentNode = lastNode;
+                }
+            }
+        }
+    }
+    if (best == Unreachable)
+        return result;
+    result.push_back(Link(std::min(interfaceNodeA, firstInterfaceNode), std::max(interfaceNodeA, firstInterfaceNode)));
+    // Walk back from the last to the first component
+    std::vector< std::size_t > path(1, lastComponentNode);
+    if (firstComponentNode != lastComponentNode)
+    {
+        const int firstSlot(routingSlots[firstComponentNode]);
+        for (int slot = predecessors[firstSlot * routingWidth + routingSlots[lastComponentNode]]; slot >= 0; slot = predecessors[firstSlot * routingWidth + slot])
+        {
+            path.push_back(routedNodes[slot]);
+            if (slot == firstSlot)
+                break;
+        }
+    }
+    for (std::size_t i = path.size() - 1; i > 0; --i)
+        result.push_back(componentLinks.at(std::make_pair(path[i], path[i-1])));
+    result.push_back(Link(std::min(lastInterfaceNode, interfaceNodeB), std::max(lastInterfaceNode, interfaceNodeB)));
+    return result;
+}
+
+const UniqueId& Reachability::uidOf(const std::size_t node) const
+{
+    return uids[node];
+}
+
+bool Reachability::reachable(const UniqueId& a, const UniqueId& b) const
+{
+    const int aNode(indexOf(a));
+    const int bNode(indexOf(b));
+    if ((aNode < 0) || (bNode < 0))
+        return (a == b);
+    return (hopsBetween(aNode, bNode) <= hopLimit);
+}
+
+bool Reachability::reachableFrom(const UniqueId& interfaceUid, const UniqueId& componentUid) const
+{
+    const int interfaceNode(indexOf(interfaceUid));
+    const int componentNode(indexOf(componentUid));
+    if ((interfaceNode < 0) || (componentNode < 0))
+        return false;
+    return (hopsFrom(interfaceNode, componentNode) <= hopLimit);
+}
+
+bool Reachability::reachableVia(const UniqueId& interfaceUidA, const UniqueId& interfaceUidB) const
+{
+    const int nodeA(indexOf(interfaceUidA));
+    const int nodeB(indexOf(interfaceUidB));
+    if ((nodeA < 0) || (nodeB < 0))
+        return false;
+    return (hopsVia(nodeA, nodeB) <= hopLimit);
+}
+
+// The reachability index of a mapping run is the run context of its threads (the match functions are static, so they cannot carry it)
+// NOTE: The solvers install it in the threads they spawn as well (see ResourceCost::RunContext)
+
+namespace {
+
+// Builds a reachability index for a mapping run unless an enclosing run has done so already
+class ReachabilityScope
+{
+    public:
+        ReachabilityScope(const ResourceCost::Model& rcm, const unsigned int maxHops)
+        {
+            if (!dynamic_cast< const Reachability* >(ResourceCost::RunContext::current()))
+            {
+                owned.reset(new Reachability(rcm, maxHops));
+                scope.reset(new ResourceCost::RunContext::Scope(owned.get()));
+            }
+        }
+        // Lets a worker thread use the index of the run it works for
+        explicit ReachabilityScope(const Reachability& shared)
+        : scope(new ResourceCost::RunContext::Scope(&shared))
+        {
+        }
+
+    protected:
+        // NOTE: The scope has to end before the index it installed is destroyed
+        std::unique_ptr< Reachability > owned;
+        std::unique_ptr< ResourceCost::RunContext::Scope > scope;
+};
+
+// Returns the index of the current mapping run
+// NOTE: Only valid within a ReachabilityScope
+const Reachability& activeReachability()
+{
+    return *dynamic_cast< const Reachability* >(ResourceCost::RunContext::current());
+}
+
+// Returns the index of the current mapping run or (outside of a run, e.g. a single call of a match function) a new index in the given storage
+const Reachability& reachabilityOf(const ResourceCost::Model& rcm, std::unique_ptr< Reachability >& storage)
+{
+    const Reachability* active(dynamic_cast< const Reachability* >(ResourceCost::RunContext::current()));
+    if (active)
+        return *active;
+    // Respect the hop limit, if the model is a mapper
+    const Mapper* mapper(dynamic_cast< const Mapper* >(&rcm));
+    storage.reset(new Reachability(rcm, mapper ? mapper->maxHops() : 1));
+    return *storage;
+}
+
+// Checks if every uid is one of the given nodes
+bool containsAll(const Reachability& reachability, const std::vector< std::size_t >& nodes, const Hyperedges& uids)
+{
+    for (const UniqueId& uid : uids)
+    {
+        if (!reachability.contains(nodes, uid))
+            return false;
+    }
+    return true;
+}
+
+// Sum of the data rates needed by a sw interface
+float dataRateOf(const ResourceCost::Model& rcm, const UniqueId& swInterfaceUid)
+{
+    float rate(0.f);
+    for (const UniqueId& demandUid : rcm.demandsOf(Hyperedges{swInterfaceUid}, Hyperedges{Mapper::DataRateUid}))
+        rate += rcm.amountOf(demandUid);
+    return rate;
+}
+
+// Keeps track of the data rates routed over the hw links (see Mapper::mapAllSwAndHwInterfaces)
+class LinkLedger
+{
+    public:
+        typedef std::map< Reachability::Link, float > Flows;
+
+        // Books the flows between all mapped sw interfaces of the given ones
+        LinkLedger(const ResourceCost::Model& rcm, const Reachability& reachability, const Hyperedges& swInterfaceUids)
+        : rcm(rcm), reachability(reachability)
+        {
+            for (const UniqueId& swInterfaceUid : swInterfaceUids)
+            {
+                const int swNode(reachability.indexOf(swInterfaceUid));
+                if (swNode < 0)
+                    continue;
+                for (const UniqueId& hwInterfaceUid : rcm.providersOf(Hyperedges{swInterfaceUid}))
+                {
+                    // Every flow is booked by the sw interface with the smaller node
+                    book(flowsOf(swInterfaceUid, hwInterfaceUid, static_cast< std::size_t >(swNode) + 1));
+                }
+            }
+        }
+
+        // Returns the flows (per link) between a sw interface mapped to a hw interface and its mapped neighbours (with a node of at least minNeighbourNode)
+        Flows flowsOf(const UniqueId& swInterfaceUid, const UniqueId& hwInterfaceUid, const std::size_t minNeighbourNode=0) const
+        {
+            Flows flows;
+            const int swNode(reachability.indexOf(swInterfaceUid));
+            const int hwNode(reachability.indexOf(hwInterfaceUid));
+            if ((swNode < 0) || (hwNode < 0))
+                return flows;
+            const float rate(rateOf(swInterfaceUid));
+            for (const std::size_t neighbourNode : reachability.adjacentInterfacesOf(swNode))
+            {
+                if (neighbourNode < minNeighbourNode)
+                    continue;
+                const UniqueId& neighbourUid(reachability.uidOf(neighbourNode));
+                const float flow(std::max(rate, rateOf(neighbourUid)));
+                if (flow <= 0.f)
+                    continue;
+                for (const UniqueId& targetUid : rcm.providersOf(Hyperedges{neighbourUid}))
+                {
+                    const int targetNode(reachability.indexOf(targetUid));
+                    if (targetNode < 0)
+                        continue;
+                    for (const Reachability::Link& link : reachability.linksVia(hwNode, targetNode))
+                        flows[link] += flow;
+                }
+            }
+            return flows;
+        }
+
+        // Checks if the links can carry the additional flows
+        bool fits(const Flows& flows) const
+        {
+            for (const Flows::value_type& flow : flows)
+            {
+                if (loadOf(flow.first) + flow.second > capacityOf(flow.first))
+                    return false;
+            }
+            return true;
+        }
+
+        void book(const Flows& flows)
+        {
+            for (const Flows::value_type& flow : flows)
+                loads[flow.first] += flow.second;
+        }
+
+        float loadOf(const Reachability::Link& link) const
+        {
+            Flows::const_iterator it(loads.find(link));
+            return (it != loads.end()) ? it->second : 0.f;
+        }
+
+    protected:
+        float rateOf(const UniqueId& swInterfaceUid) const
+        {
+            std::map< UniqueId, float >::const_iterator it(rates.find(swInterfaceUid));
+            if (it != rates.end())
+                return it->second;
+            const float rate(dataRateOf(rcm, swInterfaceUid));
+            rates[swInterfaceUid] = rate;
+            return rate;
+        }
+
+        // Smaller capacity of both ends of a link (or infinity, if no end declares one)
+        float capacityOf(const Reachability::Link& link) const
+        {
+            Flows::const_iterator it(capacities.find(link));
+            if (it != capacities.end())
+                return it->second;
+            float capacity(std::numeric_limits<float>::infinity());
+            for (const std::size_t node : {link.first, link.second})
+            {
+                const Hyperedges& availableResourceUids(rcm.resourcesOf(Hyperedges{reachability.uidOf(node)}, Hyperedges{Mapper::DataRateUid}));
+                if (availableResourceUids.empty())
+                    continue;
+                float provided(0.f);
+                for (const UniqueId& availableResourceUid : availableResourceUids)
+                    provided += rcm.amountOf(availableResourceUid);
+                capacity = std::min(capacity, provided);
+            }
+            capacities[link] = capacity;
+            return capacity;
+        }
+
+        const ResourceCost::Model& rcm;
+        const Reachability& reachability;
+        Flows loads;
+        mutable Flows capacities;
+        mutable std::map< UniqueId, float > rates;
+};
+
+// FNV-1a (64 bit), so hashes are the same on every platform and in every run
+std::string hashOf(const std::string& text)
+{
+    unsigned long long hash(14695981039346656037ull);
+    for (const char c : text)
+    {
+        hash ^= static_cast< unsigned char >(c);
+        hash *= 1099511628211ull;
+    }
+    std::ostringstream result;
+    result << std::hex << std::setw(16) << std::setfill('0') << hash;
+    return result.str();
+}
+
+// Sorted classes of some instance
+std::string describeClasses(const ResourceCost::Model& rcm, const UniqueId& uid)
+{
+    Hyperedges classUids(rcm.instancesOf(Hyperedges{uid}, "", Hypergraph::TraversalDirection::FORWARD));
+    std::sort(classUids.begin(), classUids.end());
+    std::ostringstream description;
+    for (const UniqueId& classUid : classUids)
+        description << classUid << ",";
+    return description.str();
+}
+
+// Sorted classes and amounts of some resources
+std::string describeResources(const ResourceCost::Model& rcm, const Hyperedges& resourceUids)
+{
+    std::vector< std::string > descriptions;
+    for (const UniqueId& resourceUid : resourceUids)
+    {
+        std::ostringstream description;
+        description << describeClasses(rcm, resourceUid) << "=" << std::setprecision(9) << rcm.amountOf(resourceUid);
+        descriptions.push_back(description.str());
+    }
+    std::sort(descriptions.begin(), descriptions.end());
+    std::ostringstream result;
+    for (const std::string& description : descriptions)
+        result << description << ";";
+    return result.str();
+}
+
+// Sorted interfaces of a component with their classes, resources (demands or provisions) and the interfaces they are connected to
+std::string describeInterfaces(const ResourceCost::Model& rcm, const Component::NetworkView& net, const Reachability& reachability, const UniqueId& componentUid, const bool demands)
+{
+    Hyperedges interfaceUids(net.interfacesOf(Hyperedges{componentUid}));
+    std::sort(interfaceUids.begin(), interfaceUids.end());
+    std::ostringstream description;
+    for (const UniqueId& interfaceUid : interfaceUids)
+    {
+        description << "|" << interfaceUid << ":" << describeClasses(rcm, interfaceUid) << ":" << describeResources(rcm, demands ? rcm.demandsOf(Hyperedges{interfaceUid}) : rcm.resourcesOf(Hyperedges{interfaceUid})) << ":";
+        const int node(reachability.indexOf(interfaceUid));
+        if (node < 0)
+            continue;
+        Hyperedges neighbourUids(reachability.uidsOf(reachability.adjacentInterfacesOf(node)));
+        std::sort(neighbourUids.begin(), neighbourUids.end());
+        for (const UniqueId& neighbourUid : neighbourUids)
+            description << neighbourUid << ",";
+    }
+    return description.str();
+}
+
+}
+
+CommunicationObjective::CommunicationObjective(const ResourceCost::Model& rcm, const Reachability& reachability, const double weight)
+: reachability(reachability), costWeight(weight), total(0.0)
+{
+    const Software::NetworkView sw(rcm);
+    for (const UniqueId& implementationUid : sw.implementations())
+    {
+        const int implementationNode(reachability.indexOf(implementationUid));
+        if (implementationNode < 0)
+            continue;
+        for (const UniqueId& interfaceUid : sw.interfacesOf(Hyperedges{implementationUid}))
+        {
+            const int interfaceNode(reachability.indexOf(interfaceUid));
+            if (interfaceNode < 0)
+                continue;
+            const float rate(dataRateOf(rcm, interfaceUid));
+            for (const std::size_t neighbourNode : reachability.adjacentInterfacesOf(interfaceNode))
+            {
+                const float flow(std::max(rate, dataRateOf(rcm, reachability.uidOf(neighbourNode))));
+                for (const std::size_t ownerNode : reachability.ownersOf(neighbourNode))
+                {
+                    // Every connection is counted by the implementation with the smaller node (connections within an implementation do not count)
+                    if (ownerNode <= static_cast< std::size_t >(implementationNode))
+                        continue;
+                    traffic[std::make_pair(implementationNode, ownerNode)] += (flow > 0.f) ? flow : 1.0;
+                }
+            }
+        }
+    }
+    for (const std::map< std::pair< std::size_t, std::size_t >, double >::value_type& pair : traffic)
+    {
+        total += pair.second;
+        neighbours[reachability.uidOf(pair.first.first)].push_back(reachability.uidOf(pair.first.second));
+        neighbours[reachability.uidOf(pair.first.second)].push_back(reachability.uidOf(pair.first.first));
+    }
+}
+
+Hyperedges CommunicationObjective::neighboursOf(const UniqueId& implementationUid) const
+{
+    std::unordered_map< UniqueId, Hyperedges >::const_iterator it(neighbours.find(implementationUid));
+    return (it != neighbours.end()) ? it->second : Hyperedges();
+}
+
+double CommunicationObjective::costsBetween(const UniqueId& implementationUidA, const UniqueId& processorUidA, const UniqueId& implementationUidB, const UniqueId& processorUidB) const
+{
+    const double amount(trafficBetween(implementationUidA, implementationUidB));
+    if ((amount <= 0.0) || (processorUidA == processorUidB))
+        return 0.0;
+    const int nodeA(reachability.indexOf(processorUidA));
+    const int nodeB(reachability.indexOf(processorUidB));
+    unsigned int hops((nodeA < 0) || (nodeB < 0) ? Reachability::Unreachable : reachability.hopsBetween(nodeA, nodeB));
+    // NOTE: The match function rejects unreachable processors anyway, but they should never look cheaper than reachable ones
+    if (hops == Reachability::Unreachable)
+        hops = reachability.maxHops() + 1;
+    return costWeight * amount * hops / total;
+}
+
+double CommunicationObjective::trafficBetween(const UniqueId& implementationUidA, const UniqueId& implementationUidB) const
+{
+    const int nodeA(reachability.indexOf(implementationUidA));
+    const int nodeB(reachability.indexOf(implementationUidB));
+    if ((nodeA < 0) || (nodeB < 0))
+        return 0.0;
+    std::map< std::pair< std::size_t, std::size_t >, double >::const_iterator it(traffic.find(std::make_pair(std::min(nodeA, nodeB), std::max(nodeA, nodeB))));
+    return (it != traffic.end()) ? it->second : 0.0;
+}
+
+double CommunicationObjective::totalTraffic() const
+{
+    return total;
+}
+
+MappingCache::MappingCache(const std::string& directory)
+: dirName(directory)
+{
+    mkdir(dirName.c_str(), 0755);
+}
+
+std::string MappingCache::dirNameOf(const std::string& hardwareHash) const
+{
+    return dirName + "/" + hardwareHash;
+}
+
+bool MappingCache::read(const std::string& fileName, Entry& entry) const
+{
+    std::ifstream fin(fileName);
+    if (!fin.good())
+        return false;
+    entry = Entry();
+    std::string line;
+    while (std::getline(fin, line))
+    {
+        // Every line is a tab separated record
+        std::vector< std::string > fields;
+        std::istringstream record(line);
+        std::string field;
+        while (std::getline(record, field, '\t'))
+            fields.push_back(field);
+        if ((fields.size() == 2) && (fields[0] == "hardware"))
+            entry.hardwareHash = fields[1];
+        else if ((fields.size() == 3) && (fields[0] == "implementation"))
+            entry.implementationHashes[fields[1]] = fields[2];
+        else if ((fields.size() == 3) && (fields[0] == "executed-on"))
+            entry.executedOn.push_back(std::make_pair(fields[1], fields[2]));
+        else if ((fields.size() == 3) && (fields[0] == "reachable-via"))
+            entry.reachableVia.push_back(std::make_pair(fields[1], fields[2]));
+    }
+    return !entry.hardwareHash.empty();
+}
+
+bool MappingCache::find(const std::string& hardwareHash, const std::string& hash, Entry& entry) const
+{
+    return read(dirNameOf(hardwareHash) + "/" + hash + ".cache", entry) && (entry.hardwareHash == hardwareHash);
+}
+
+std::size_t MappingCache::findSimilar(const std::string& hardwareHash, const std::map< UniqueId, std::string >& implementationHashes, Entry& entry) const
+{
+    // Only the entries for the same hardware are candidates
+    const std::string& hardwareDirName(dirNameOf(hardwareHash));
+    DIR* dir(opendir(hardwareDirName.c_str()));
+    if (!dir)
+        return 0;
+    std::vector< std::string > fileNames;
+    for (struct dirent* dirEntry = readdir(dir); dirEntry; dirEntry = readdir(dir))
+    {
+        const std::string fileName(dirEntry->d_name);
+        if ((fileName.size() > 6) && (fileName.compare(fileName.size() - 6, 6, ".cache") == 0))
+            fileNames.push_back(fileName);
+    }
+    closedir(dir);
+    // Sorted, so ties are broken the same way every time
+    std::sort(fileNames.begin(), fileNames.end());
+    std::size_t best(0);
+    for (const std::string& fileName : fileNames)
+    {
+        Entry candidate;
+        if (!read(hardwareDirName + "/" + fileName, candidate) || (candidate.hardwareHash != hardwareHash))
+            continue;
+        std::size_t shared(0);
+        for (const std::map< UniqueId, std::string >::value_type& pair : implementationHashes)
+        {
+            std::map< UniqueId, std::string >::const_iterator it(candidate.implementationHashes.find(pair.first));
+            if ((it != candidate.implementationHashes.end()) && (it->second == pair.second))
+                ++shared;
+        }
+        if (shared <= best)
+            continue;
+        best = shared;
+        entry = candidate;
+    }
+    return best;
+}
+
+bool MappingCache::store(const std::string& hash, const Entry& entry) const
+{
+    mkdir(dirNameOf(entry.hardwareHash).c_str(), 0755);
+    const std::string fileName(dirNameOf(entry.hardwareHash) + "/" + hash + ".cache");
+    // Other processes (and other threads of this one) may store the same hash concurrently
+    std::ostringstream suffix;
+    suffix << ".tmp" << getpid() << "." << std::hash< std::thread::id >()(std::this_thread::get_id());
+    const std::string tmpName(fileName + suffix.str());
+    {
+        std::ofstream fout(tmpName);
+        if (!fout.good())
+        {
+            std::remove(tmpName.c_str());
+            return false;
+        }
+        fout << "hardware\t" << entry.hardwareHash << "\n";
+        for (const std::map< UniqueId, std::string >::value_type& pair : entry.implementationHashes)
+            fout << "implementation\t" << pair.first << "\t" << pair.second << "\n";
+        for (const std::pair< UniqueId, UniqueId >& fact : entry.executedOn)
+            fout << "executed-on\t" << fact.first << "\t" << fact.second << "\n";
+        for (const std::pair< UniqueId, UniqueId >& fact : entry.reachableVia)
+            fout << "reachable-via\t" << fact.first << "\t" << fact.second << "\n";
+        fout.close();
+        if (fout.fail())
+        {
+            std::remove(tmpName.c_str());
+            return false;
+        }
+    }
+    if (std::rename(tmpName.c_str(), fileName.c_str()) != 0)
+    {
+        std::remove(tmpName.c_str());
+        return false;
+    }
+    return true;
+}
+
 const UniqueId Mapper::ExecutedOnUid="Software::Hardware::Mapper::ExecutedOn";
 const UniqueId Mapper::ReachableViaUid="Software::Hardware::Mapper::ReachableVia";
+const UniqueId Mapper::DataRateUid="Software::Hardware::Mapper::DataRate";
+
+Mapper::Mapper(const ResourceCost::Model& rcm,
+       const Software::Network& sw,
+       const ::Hardware::Computational::Network& hw
+      )
+: numThreads(1), hopLimit(1), commWeight(1.0)
+{
+    importFrom(rcm);
+    importFrom(sw);
+    importFrom(hw);
+    createMainConcepts();
+}
+
+Mapper::Mapper(const ResourceCost::Model& rcm,
+       const Software::NetworkOverlay& sw,
+       const ::Hardware::Computational::Network& hw
+      )
+: numThreads(1), hopLimit(1), commWeight(1.0)
+{
+    importFrom(rcm);
+    importFrom(sw.base());
+    sw.apply(*this);
+    importFrom(hw);
+    createMainConcepts();
+}
+
+void Mapper::createMainConcepts()
+{
+    indexResources();
+    
+    // Make sure that both relations exist
+    subrelationFrom(ExecutedOnUid, Hyperedges{Software::Network::ImplementationId}, Hyperedges{::Hardware::Computational::Network::ProcessorId}, ResourceCost::Model::MappedToUid);
+    subrelationFrom(ReachableViaUid, Hyperedges{Software::Network::InterfaceId}, Hyperedges{::Hardware::Computational::Network::InterfaceId}, ResourceCost::Model::MappedToUid);
+    access(ExecutedOnUid).label("EXECUTED-ON");
+    access(ReachableViaUid).label("REACHABLE-VIA");
+    // ... and the resource of sw flows and hw links
+    defineResource(DataRateUid, "DATA-RATE");
+}
+
+unsigned int Mapper::threads() const
+{
+    return numThreads;
+}
+
+void Mapper::threads(const unsigned int n)
+{
+    numThreads = (n > 0) ? n : 1;
+}
+
+unsigned int Mapper::maxHops() const
+{
+    return hopLimit;
+}
+
+void Mapper::maxHops(const unsigned int n)
+{
+    hopLimit = (n > 0) ? n : 1;
+}
+
+double Mapper::communicationWeight() const
+{
+    return commWeight;
+}
+
+void Mapper::communicationWeight(const double w)
+{
+    commWeight = (w > 0.0) ? w : 0.0;
+}
+
+Hyperedges Mapper::implementations (const ResourceCost::Model& rcm)
+{
+    const Software::NetworkView sw(rcm);
+    return intersect(ResourceCost::Model::partitionFuncLeft(rcm), sw.implementations());
+}
+
+Hyperedges Mapper::unmappedImplementations (const ResourceCost::Model& rcm)
+{
+    Hyperedges result;
+    for (const UniqueId& implUid : implementations(rcm))
+    {
+        if (rcm.providersOf(Hyperedges{implUid}).empty())
+            result.push_back(implUid);
+    }
+    return result;
+}
+
+Hyperedges Mapper::processors (const ResourceCost::Model& rcm)
+{
+    const ::Hardware::Computational::NetworkView hw(rcm);
+    return intersect(ResourceCost::Model::partitionFuncRight(rcm), hw.processors());
+}
+
+Hyperedges Mapper::swInterfaces (const ResourceCost::Model& rcm)
+{
+    const Software::NetworkView sw(rcm);
+    const Hyperedges& candidateInterfaces(intersect(ResourceCost::Model::partitionFuncLeft(rcm), sw.interfacesOf(implementations(rcm))));
+    // We remove all interfaces which are pure internal interfaces. These dont have to be mapped to hw interfaces
+    Hyperedges internalInterfaces;
+    for (const UniqueId& a : candidateInterfaces)
+    {
+        // Get targets of owner
+        const Hyperedges& swOwnerUids(sw.interfacesOf(Hyperedges{a},"",Hypergraph::TraversalDirection::INVERSE));
+        const Hyperedges& swTargetUids(rcm.providersOf(swOwnerUids));
+        // Get connected interfaces
+        const Hyperedges& swNeighbourInterfaceUids(sw.endpointsOf(Hyperedges{a},"",Hypergraph::TraversalDirection::BOTH));
+        // ... and their owners
+        const Hyperedges& swNeighbourOwnerUids(sw.interfacesOf(swNeighbourInterfaceUids,"",Hypergraph::TraversalDirection::INVERSE));
+        // ... and the targets of the owners
+        const Hyperedges& swNeighbourTargetUids(rcm.providersOf(swNeighbourOwnerUids));
+        // Check that each swNeighbourTargetUid is in swTargetUids
+        if (subtract(swNeighbourTargetUids, swTargetUids).size())
+            continue; // at least one target is different
+        DIAGNOSE_RULE(Diagnostics::PARTITION_INTERNAL_INTERFACE, Diagnostics::DEBUG, "PARTITION INTERFACES: Removing pure internal sw interface: " << a);
+        internalInterfaces.push_back(a);
+    }
+    return subtract(candidateInterfaces, internalInterfaces);
+}
+
+Hyperedges Mapper::hwInterfaces (const ResourceCost::Model& rcm)
+{
+    const ::Hardware::Computational::NetworkView hw(rcm);
+    return intersect(ResourceCost::Model::partitionFuncRight(rcm), hw.interfacesOf(processors(rcm)));
+}
+
+float Mapper::matchSwToHwInterface (const ResourceCost::Model& rcm, const UniqueId& a, const UniqueId& b)
+{
+    // We have two things to check:
+    // a) resource constraints (ResourceCost::Model::matchFunc)
+    const float costs(ResourceCost::Model::matchFunc(rcm, a, b));
+    if (costs < 0.f)
+        return costs;
+
+    std::unique_ptr< Reachability > storage;
+    const Reachability& reachability(reachabilityOf(rcm, storage));
+    const int aNode(reachability.indexOf(a));
+    const int bNode(reachability.indexOf(b));
+    if ((aNode < 0) || (bNode < 0))
+    {
+        DIAGNOSE_RULE(Diagnostics::REACH_UNKNOWN_INTERFACE, Diagnostics::DEBUG, "REACH CHECK FAILED: sw interface: " << a << " hardware interface: " << b << " UNKNOWN INTERFACE");
+        return -std::numeric_limits<float>::infinity();
+    }
+
+    const Hyperedges& swTargetUids(rcm.providersOf(reachability.uidsOf(reachability.ownersOf(aNode))));
+    // RULE I: if owner of 'a' is not mapped at all, we fail
+    if (swTargetUids.empty())
+    {
+        DIAGNOSE_RULE(Diagnostics::REACH_OWNER_NOT_MAPPED, Diagnostics::DEBUG, "REACH CHECK FAILED: sw interface: " << a << " hardware interface: " << b << " OWNER NOT MAPPED");
+        return -std::numeric_limits<float>::infinity();
+    }
+    // RULE II: Check if owner of 'b' is the target of owner of 'a'
+    if (!containsAll(reachability, reachability.ownersOf(bNode), swTargetUids)) // Some entries in swTargetUids are not owners of 'b'
+    {
+        DIAGNOSE_RULE(Diagnostics::REACH_OWNER_MISMATCH, Diagnostics::DEBUG, "REACH CHECK FAILED: sw interface: " << a << " hardware interface: " << b << " OWNER MISMATCH");
+        return -std::numeric_limits<float>::infinity();
+    }
+    // NOTE: We do not have to check for internal interfaces. They have been filtered by the partition function already
+    const Hyperedges& swTargetInterfaceUids(rcm.providersOf(reachability.uidsOf(reachability.adjacentInterfacesOf(aNode))));
+    // RULE III: Some of the connections are external or unmapped. Check if every hw interface of connected interfaces can be reached via 'b' (within the hop limit)
+    for (const UniqueId& swTargetInterfaceUid : swTargetInterfaceUids)
+    {
+        if (reachability.reachableVia(b, swTargetInterfaceUid))
+            continue;
+        DIAGNOSE_RULE(Diagnostics::REACH_ENDPOINTS_UNREACHABLE, Diagnostics::DEBUG, "REACH CHECK FAILED: sw interface: " << a << " hardware interface: " << b << " ENDPOINTS UNREACHABLE");
+        return -std::numeric_limits<float>::infinity();
+    }
+    const Hyperedges& swNeighbourTargetUids(rcm.providersOf(reachability.uidsOf(reachability.adjacentOwnersOf(aNode))));
+    // RULE IV: If all remote interfaces are unmapped we are unable to verify reachability.
+    if (swNeighbourTargetUids.empty())
+    {
+        DIAGNOSE_RULE(Diagnostics::REACH_ENDPOINT_OWNERS_UNMAPPED, Diagnostics::DEBUG, "REACH CHECK FAILED: sw interface: " << a << " hardware interface: " << b << " ENDPOINT OWNERS UNMAPPED");
+        return -std::numeric_limits<float>::infinity();
+    }
+    // RULE V: owners of the endpoints of 'a' have to be mapped to components which can be reached from 'b' (within the hop limit)
+    for (const UniqueId& swNeighbourTargetUid : swNeighbourTargetUids)
+    {
+        if (reachability.reachableFrom(b, swNeighbourTargetUid))
+            continue;
+        DIAGNOSE_RULE(Diagnostics::REACH_ENDPOINT_OWNERS_MISMATCH, Diagnostics::DEBUG, "REACH CHECK FAILED: sw interface: " << a << " hardware interface: " << b << " ENDPOINT OWNERS MISMATCH");
+        return -std::numeric_limits<float>::infinity();
+    }
+    //std::cout << "REACH CHECK SUCCESSFUL sw interface: " << sw.access(a).label() << " hardware interface: " << hw.access(b).label() << " MATCH\n";
+    return costs;
+}
+
+float Mapper::matchImplementationAndProcessor (const ResourceCost::Model& rcm, const UniqueId& a, const UniqueId& b)
+{
+    // We have two things to check:
+    // a) resource constraints (ResourceCost::Model::matchFunc)
+    const float costs(ResourceCost::Model::matchFunc(rcm, a, b));
+    if (costs < 0.f)
+        return costs;
+
+    // b) reachability constraints
+    // Lets check if all neighbours of a are mapped to processors reachable from b (or b itself) or not mapped at all
+    std::unique_ptr< Reachability > storage;
+    const Reachability& reachability(reachabilityOf(rcm, storage));
+    const int aNode(reachability.indexOf(a));
+    const int bNode(reachability.indexOf(b));
+    if ((aNode < 0) || (bNode < 0))
+        return costs; // no neighbours at all
+    const Hyperedges& swTargetUids(rcm.providersOf(reachability.uidsOf(reachability.adjacentComponentsOf(aNode))));
+    // If any of the targets of sw neighbours is too many hops away, we cannot reach that sw component
+    for (const UniqueId& swTargetUid : swTargetUids)
+    {
+        if (reachability.reachable(b, swTargetUid))
+            continue;
+        // Reachability constraint failed!
+        DIAGNOSE_RULE(Diagnostics::REACH_NEIGHBOURS_UNREACHABLE, Diagnostics::DEBUG, "REACH CHECK FAILED: for consumer: " << rcm.access(a).label() << " and provider: " << rcm.access(b).label());
+        return -std::numeric_limits<float>::infinity();
+    }
+    return costs;
+}
+
+bool Mapper::equivalentProcessors (const ResourceCost::Model& rcm, const UniqueId& a, const UniqueId& b)
+{
+    if (!ResourceCost::Model::equivalentProviders(rcm, a, b))
+        return false;
+    Hyperedges aClassUids(rcm.instancesOf(Hyperedges{a}, "", Hypergraph::TraversalDirection::FORWARD));
+    Hyperedges bClassUids(rcm.instancesOf(Hyperedges{b}, "", Hypergraph::TraversalDirection::FORWARD));
+    std::sort(aClassUids.begin(), aClassUids.end());
+    std::sort(bClassUids.begin(), bClassUids.end());
+    if (aClassUids != bClassUids)
+        return false;
+    // Swapping a and b must not change the reachability of any other processor (see matchImplementationAndProcessor)
+    std::unique_ptr< Reachability > storage;
+    const Reachability& reachability(reachabilityOf(rcm, storage));
+    const int aNode(reachability.indexOf(a));
+    const int bNode(reachability.indexOf(b));
+    if ((aNode < 0) || (bNode < 0))
+        return (aNode == bNode);
+    Hyperedges aNeighbourUids(subtract(reachability.uidsOf(reachability.adjacentComponentsOf(aNode)), Hyperedges{a, b}));
+    Hyperedges bNeighbourUids(subtract(reachability.uidsOf(reachability.adjacentComponentsOf(bNode)), Hyperedges{a, b}));
+    std::sort(aNeighbourUids.begin(), aNeighbourUids.end());
+    std::sort(bNeighbourUids.begin(), bNeighbourUids.end());
+    return (aNeighbourUids == bNeighbourUids);
+}
+
+void Mapper::mapSwToHwInterface (CommonConceptGraph& g, const UniqueId& a, const UniqueId& b)
+{
+    ResourceCost::Model& rcm(static_cast< ResourceCost::Model& >(g));
+    // Map sw interface a to hw interface b
+    rcm.mapTo(Hyperedges{a}, Hyperedges{b}, Mapper::ReachableViaUid);
+}
+
+void Mapper::mapImplementationToProcessor (CommonConceptGraph& g, const UniqueId& a, const UniqueId& b)
+{
+    ResourceCost::Model& rcm(static_cast< ResourceCost::Model& >(g));
+    // Map sw implementation a to processor b
+    rcm.mapTo(Hyperedges{a}, Hyperedges{b}, Mapper::ExecutedOnUid);
+}
+
+/* Uses the implemented functions and the given solver to map software implementations to hardware processors */
+float Mapper::mapAllImplementationsToProcessors(const ResourceCost::Solver& solver)
+{
+    // Perform mapping and import results
+    const ReachabilityScope scope(*this, hopLimit);
+    const CommunicationObjective communication(*this, activeReachability(), commWeight);
+    const Hyperedges& pendingUids(unmappedImplementations(*this));
+    const ResourceCost::Model result(solver.solve(*this, unmappedImplementations, processors, matchImplementationAndProcessor, mapImplementationToProcessor, numThreads, communication));
+    importFrom(result);
+    // Only the implementations mapped by the solver add to the ledger (instead of rebuilding it)
+    for (const UniqueId& implUid : pendingUids)
+    {
+        for (const UniqueId& hwUid : providersOf(Hyperedges{implUid}))
+            book(implUid, hwUid);
+    }
+
+    return globalCosts();
+}
+
+float Mapper::globalCosts() const
+{
+    // Check if every sw implementation could be mapped
+    const Hyperedges& implUids(implementations(*this));
+    for (const UniqueId& implUid : implUids)
+    {
+        if (!providersOf(Hyperedges{implUid}).size())
+        {
+            DIAGNOSE_RULE(Diagnostics::COMPLETENESS_NO_PROVIDER, Diagnostics::WARNING, "COMPLETENESS CHECK FAILED: " << access(implUid).label() << " has no provider");
+            return -std::numeric_limits<float>::infinity();
+        }
+    }
+
+    // Calculate global costs
+    float costs(0.f);
+    const Hyperedges& hwUids(processors(*this));
+    for (const UniqueId& hwUid : hwUids)
+    {
+        const Hyperedges& availableResourceUids(resourcesOf(Hyperedges{hwUid}));
+        for (const UniqueId& availableResourceUid : availableResourceUids)
+        {
+            const float available(amountOf(availableResourceUid));
+            const float used(usageOf(availableResourceUid));
+            costs += (available - used) / available;
+        }
+    }
+    // NOTE: Greater means better :)
+    return (hwUids.size() > 0 ? costs / hwUids.size() : 0.f);
+}
+
+float Mapper::communicationCosts() const
+{
+    const ReachabilityScope scope(*this, hopLimit);
+    const CommunicationObjective communication(*this, activeReachability());
+    return communication.costsOf(*this, implementations(*this));
+}
+
+float Mapper::objective() const
+{
+    return globalCosts() - commWeight * communicationCosts();
+}
+
+float Mapper::mapAllSwAndHwInterfaces()
+{
+    const ReachabilityScope scope(*this, hopLimit);
+    const Software::NetworkView sw(*this);
+    LinkLedger ledger(*this, activeReachability(), sw.interfacesOf(implementations(*this)));
+
+    // Perform greedy mapping (see ResourceCost::Model::map) and book the flows of every mapped sw interface on the hw links
+    const Hyperedges& swUids(swInterfaces(*this));
+    const Hyperedges& hwUids(hwInterfaces(*this));
+    pack(swUids, hwUids);
+    precompute(numThreads);
+    for (const UniqueId& swUid : swUids)
+    {
+        float bestCosts(-std::numeric_limits<float>::infinity());
+        UniqueId bestHwUid;
+        LinkLedger::Flows bestFlows;
+        for (const UniqueId& hwUid : hwUids)
+        {
+            const float costs(matchSwToHwInterface(*this, swUid, hwUid));
+            if ((costs < 0.f) || (costs <= bestCosts))
+                continue;
+            const LinkLedger::Flows& flows(ledger.flowsOf(swUid, hwUid));
+            if (!ledger.fits(flows))
+            {
+                DIAGNOSE_RULE(Diagnostics::BANDWIDTH_LINK_OVERSUBSCRIBED, Diagnostics::DEBUG, "BANDWIDTH CHECK FAILED: sw interface: " << swUid << " hardware interface: " << hwUid << " LINK OVERSUBSCRIBED");
+                continue;
+            }
+            bestCosts = costs;
+            bestHwUid = hwUid;
+            bestFlows = flows;
+        }
+        // Negative costs denote an invalid match
+        if (bestCosts < 0.f)
+            continue;
+        mapSwToHwInterface(*this, swUid, bestHwUid);
+        ledger.book(bestFlows);
+    }
+    unpack();
+
+    return 0.f;
+}
+
+float Mapper::linkLoadOf(const UniqueId& hwInterfaceUidA, const UniqueId& hwInterfaceUidB) const
+{
+    const ReachabilityScope scope(*this, hopLimit);
+    const Software::NetworkView sw(*this);
+    const LinkLedger ledger(*this, activeReachability(), sw.interfacesOf(implementations(*this)));
+    const int nodeA(activeReachability().indexOf(hwInterfaceUidA));
+    const int nodeB(activeReachability().indexOf(hwInterfaceUidB));
+    if ((nodeA < 0) || (nodeB < 0))
+        return 0.f;
+    return ledger.loadOf(Reachability::Link(std::min(nodeA, nodeB), std::max(nodeA, nodeB)));
+}
+
+float Mapper::improve(const ResourceCost::AnnealingSolver& annealer)
+{
+    // The interface mapping has to follow the implementations, so we drop it ...
+    const ReachabilityScope scope(*this, hopLimit);
+    const Software::NetworkView sw(*this);
+    unmap(sw.interfacesOf(implementations(*this)));
+    const CommunicationObjective communication(*this, activeReachability(), commWeight);
+    annealer.improve(*this, implementations, processors, matchImplementationAndProcessor, mapImplementationToProcessor, communication);
+    const float globalCostsA(globalCosts());
+    // ... and redo it
+    mapAllSwAndHwInterfaces();
+    return globalCostsA;
+}
+
+namespace {
+
+// The part of the model a worker of Mapper::mapHierarchically() maps (the partition functions are static, so they cannot carry it)
+static thread_local const Hyperedges* activeImplementations(NULL);
+static thread_local const Hyperedges* activeProcessors(NULL);
+
+Hyperedges subproblemImplementations (const ResourceCost::Model& rcm)
+{
+    return *activeImplementations;
+}
+
+Hyperedges subproblemProcessors (const ResourceCost::Model& rcm)
+{
+    return *activeProcessors;
+}
+
+// Implementations to be mapped onto some processors (independently of all other subproblems)
+struct Subproblem
+{
+    Hyperedges implementationUids;
+    Hyperedges processorUids;
+    // The amounts of the resources reserved for the subproblem (see Mapper::mapDecomposed). All other resources keep the amounts of the mapper.
+    std::unordered_map< UniqueId, float > reserved;
+};
+
+// Solves the subproblems in parallel (every worker uses the index of the current run) and maps the implementations of the mapper accordingly
+void solveAll(Mapper& mapper, const ResourceCost::Solver& solver, const std::vector< Subproblem >& subproblems, const CommunicationObjective& communication, const unsigned int threads)
+{
+    const Reachability& reachability(activeReachability());
+    std::vector< ResourceCost::Model > results(subproblems.size());
+    std::atomic< std::size_t > next(0);
+    const unsigned int nWorkers(std::max(1u, std::min< unsigned int >(threads, subproblems.size())));
+    auto worker = [&] () {
+        const ReachabilityScope shared(reachability);
+        // Subproblems with reserved resources are solved on a copy of the model (one per worker), which gets the reserved amounts while solving them
+        std::unique_ptr< ResourceCost::Model > working;
+        for (std::size_t k = next++; k < subproblems.size(); k = next++)
+        {
+            const std::unordered_map< UniqueId, float >& reserved(subproblems[k].reserved);
+            if (!reserved.empty() && !working)
+                working.reset(new ResourceCost::Model(mapper));
+            for (const std::pair< const UniqueId, float >& entry : reserved)
+                working->amountOf(entry.first, entry.second);
+            activeImplementations = &subproblems[k].implementationUids;
+            activeProcessors = &subproblems[k].processorUids;
+            // Threads left over by the pool can be used by the solver
+            const ResourceCost::Model& model(reserved.empty() ? mapper : *working);
+            results[k] = solver.solve(model, subproblemImplementations, subproblemProcessors, Mapper::matchImplementationAndProcessor, Mapper::mapImplementationToProcessor, (subproblems.size() > 1) ? 1 : threads, communication);
+            for (const std::pair< const UniqueId, float >& entry : reserved)
+                working->amountOf(entry.first, mapper.amountOf(entry.first));
+        }
+        activeImplementations = NULL;
+        activeProcessors = NULL;
+    };
+    std::vector< std::thread > pool;
+    for (unsigned int i = 1; i < nWorkers; ++i)
+        pool.push_back(std::thread(worker));
+    worker();
+    for (std::thread& t : pool)
+        t.join();
+
+    // The subproblems do not share any resources (or only their reserved parts), but their neighbours have been unmapped while solving them.
+    // So every assignment is checked against the ones merged before. Rejected implementations are mapped by the final pass.
+    for (std::size_t k = 0; k < subproblems.size(); ++k)
+    {
+        for (const UniqueId& implUid : subproblems[k].implementationUids)
+        {
+            for (const UniqueId& procUid : intersect(results[k].providersOf(Hyperedges{implUid}), subproblems[k].processorUids))
+            {
+                if (Mapper::matchImplementationAndProcessor(mapper, implUid, procUid) < 0.f)
+                {
+                    DIAGNOSE(Diagnostics::DEBUG, "MERGE REJECTED: " << mapper.access(implUid).label() << " on " << mapper.access(procUid).label());
+                    continue;
+                }
+                Mapper::mapImplementationToProcessor(mapper, implUid, procUid);
+            }
+        }
+    }
+}
+
+// Returns the resources consumed by an implementation
+Hyperedges consumedBy(const ResourceCost::Model& rcm, const UniqueId& implUid)
+{
+    return rcm.isPointingTo(rcm.factsOf(rcm.subrelationsOf(Hyperedges{ResourceCost::Model::ConsumesUid}), Hyperedges{implUid}));
+}
+
+// Books the consumed resources of an implementation on top of the residuals (which are left unchanged). Returns false if they do not fit.
+// NOTE: A demand cannot be split, so it is booked on the compatible resource with the most residuals left
+bool bookOn(const ResourceCost::Model& rcm, const Hyperedges& consumedUids, const Hyperedges& availableUids, const std::unordered_map< UniqueId, float >& residuals, std::unordered_map< UniqueId, float >& booked)
+{
+    for (const UniqueId& consumedUid : consumedUids)
+    {
+        const UniqueId* bestUid(NULL);
+        float bestLeft(0.f);
+        for (const UniqueId& availableUid : availableUids)
+        {
+            if (!rcm.compatible(consumedUid, availableUid))
+                continue;
+            const auto& it(booked.find(availableUid));
+            const float left(residuals.at(availableUid) - ((it != booked.end()) ? it->second : 0.f));
+            if (!bestUid || (left > bestLeft))
+            {
+                bestUid = &availableUid;
+                bestLeft = left;
+            }
+        }
+        if (!bestUid || (bestLeft < rcm.amountOf(consumedUid)))
+            return false;
+        booked[*bestUid] += rcm.amountOf(consumedUid);
+    }
+    return true;
+}
 
-Mapper::Mapper(const ResourceCost::Model& rcm,
-       const Software::Network& sw,
-       const ::Hardware::Computational::Network& hw
-      )
+// Returns the sum of the fractions of their resources the booked amounts take
+double fractionsOf(const ResourceCost::Model& rcm, const std::unordered_map< UniqueId, float >& booked)
 {
-    importFrom(rcm);
-    importFrom(sw);
-    importFrom(hw);
-    
-    // Make sure that both relations exist
-    subrelationFrom(ExecutedOnUid, Hyperedges{Software::Network::ImplementationId}, Hyperedges{::Hardware::Computational::Network::ProcessorId}, ResourceCost::Model::MappedToUid);
-    subrelationFrom(ReachableViaUid, Hyperedges{Software::Network::InterfaceId}, Hyperedges{::Hardware::Computational::Network::InterfaceId}, ResourceCost::Model::MappedToUid);
-    access(ExecutedOnUid).label("EXECUTED-ON");
-    access(ReachableViaUid).label("REACHABLE-VIA");
+    double fractions(0.0);
+    for (const std::pair< const UniqueId, float >& entry : booked)
+        fractions += entry.second / rcm.amountOf(entry.first);
+    return fractions;
 }
 
-Hyperedges Mapper::implementations (const ResourceCost::Model& rcm)
+// Splits the mapping of implementations to processors along the PART-OF hierarchy of the devices
+class Hierarchy
 {
-    const Software::Network& sw(static_cast<const ResourceCost::Model&>(rcm));
-    return intersect(ResourceCost::Model::partitionFuncLeft(rcm), sw.implementations());
+    public:
+        Hierarchy(const ResourceCost::Model& rcm, const Reachability& reachability, const CommunicationObjective& communication, const double weight)
+        : model(rcm), reachability(reachability), objective(communication), commWeight(weight)
+        {
+            const ::Hardware::Computational::NetworkView hw(rcm);
+            for (const UniqueId& procUid : Mapper::processors(rcm))
+            {
+                // Walk up to the outermost device (a device may be part of several ones, then we follow the first)
+                Hyperedges& path(paths[procUid]);
+                for (UniqueId uid(procUid); std::find(path.begin(), path.end(), uid) == path.end(); )
+                {
+                    path.insert(path.begin(), uid);
+                    const Hyperedges& compositeUids(hw.subcomponentsOf(Hyperedges{uid}, "", Hypergraph::TraversalDirection::FORWARD));
+                    if (compositeUids.empty())
+                        break;
+                    uid = compositeUids[0];
+                }
+                for (const UniqueId& uid : path)
+                    processorsIn[uid].push_back(procUid);
+            }
+        }
+
+        // Returns the device containing a processor at the given depth (or the processor itself)
+        const UniqueId& groupOf(const UniqueId& procUid, const std::size_t depth) const
+        {
+            const Hyperedges& path(paths.at(procUid));
+            return path[std::min(depth, path.size() - 1)];
+        }
+
+        // Splits the mapping of the implementations onto the processors into subproblems
+        void split(const Hyperedges& implUids, const Hyperedges& procUids, std::vector< Subproblem >& subproblems, const std::size_t depth=0)
+        {
+            if (implUids.empty() || procUids.empty())
+                return;
+            Hyperedges groupUids;
+            std::unordered_map< UniqueId, Hyperedges > members;
+            bool deeper(false);
+            for (const UniqueId& procUid : procUids)
+            {
+                const UniqueId& groupUid(groupOf(procUid, depth));
+                if (members[groupUid].empty())
+                    groupUids.push_back(groupUid);
+                members[groupUid].push_back(procUid);
+                deeper = deeper || (paths.at(procUid).size() > depth + 1);
+            }
+            if (groupUids.size() == procUids.size())
+            {
+                // Every group is a single processor, so this is up to the solver
+                subproblems.push_back(Subproblem{implUids, procUids});
+                return;
+            }
+            if ((groupUids.size() == 1) && deeper)
+            {
+                split(implUids, procUids, subproblems, depth + 1);
+                return;
+            }
+
+            // Assign the implementations to the groups and split every group further
+            std::unordered_map< UniqueId, Hyperedges > assigned;
+            assign(implUids, groupUids, members, depth, assigned);
+            for (const UniqueId& groupUid : groupUids)
+                split(assigned[groupUid], members[groupUid], subproblems, depth + 1);
+        }
+
+    protected:
+        // Residual resources of the groups of processors at one level
+        struct Groups
+        {
+            std::unordered_map< UniqueId, Hyperedges > availableUids;
+            std::unordered_map< UniqueId, float > residuals;
+            // Per group: the sum of the fractions of its resources which are left
+            std::unordered_map< UniqueId, double > slacks;
+        };
+
+        // Returns the clusters of communicating implementations (in order of their first implementations)
+        std::vector< Hyperedges > clustersOf(const Hyperedges& implUids) const
+        {
+            std::vector< Hyperedges > result;
+            std::unordered_map< UniqueId, std::size_t > clusterOf;
+            for (const UniqueId& implUid : implUids)
+                clusterOf[implUid] = implUids.size();
+            for (const UniqueId& implUid : implUids)
+            {
+                if (clusterOf[implUid] < implUids.size())
+                    continue;
+                const std::size_t cluster(result.size());
+                result.push_back(Hyperedges{implUid});
+                clusterOf[implUid] = cluster;
+                for (std::size_t i = 0; i < result[cluster].size(); ++i)
+                {
+                    for (const UniqueId& neighbourUid : objective.neighboursOf(result[cluster][i]))
+                    {
+                        const auto& it(clusterOf.find(neighbourUid));
+                        if ((it == clusterOf.end()) || (it->second < implUids.size()))
+                            continue;
+                        it->second = cluster;
+                        result[cluster].push_back(neighbourUid);
+                    }
+                }
+            }
+            return result;
+        }
+
+        // Assigns implementations to groups of processors greedily: clusters of communicating implementations as a whole (largest demand first) or, if they do not fit into any group, one by one
+        void assign(const Hyperedges& implUids, const Hyperedges& groupUids, std::unordered_map< UniqueId, Hyperedges >& members, const std::size_t depth, std::unordered_map< UniqueId, Hyperedges >& assigned)
+        {
+            Groups groups;
+            for (const UniqueId& groupUid : groupUids)
+            {
+                double& slack(groups.slacks[groupUid]);
+                for (const UniqueId& resourceUid : model.resourcesOf(members[groupUid]))
+                {
+                    groups.availableUids[groupUid].push_back(resourceUid);
+                    const float residual(model.amountOf(resourceUid) - model.usageOf(resourceUid));
+                    groups.residuals[resourceUid] = residual;
+                    slack += residual / model.amountOf(resourceUid);
+                }
+            }
+
+            // Order by the amount of consumed resources (decreasing, otherwise stable)
+            std::unordered_map< UniqueId, float > demands;
+            for (const UniqueId& implUid : implUids)
+            {
+                float& demand(demands[implUid]);
+                for (const UniqueId& consumedUid : consumedBy(model, implUid))
+                    demand += model.amountOf(consumedUid);
+            }
+            std::vector< std::pair< float, Hyperedges > > order;
+            for (Hyperedges& clusterUids : clustersOf(implUids))
+            {
+                std::stable_sort(clusterUids.begin(), clusterUids.end(), [&] (const UniqueId& a, const UniqueId& b) { return demands[a] > demands[b]; });
+                float demand(0.f);
+                for (const UniqueId& implUid : clusterUids)
+                    demand += demands[implUid];
+                order.push_back(std::make_pair(demand, clusterUids));
+            }
+            std::stable_sort(order.begin(), order.end(), [] (const std::pair< float, Hyperedges >& a, const std::pair< float, Hyperedges >& b) { return a.first > b.first; });
+
+            for (const std::pair< float, Hyperedges >& entry : order)
+            {
+                if (place(entry.second, groupUids, members, depth, groups, assigned) || (entry.second.size() < 2))
+                    continue;
+                for (const UniqueId& implUid : entry.second)
+                    place(Hyperedges{implUid}, groupUids, members, depth, groups, assigned);
+            }
+        }
+
+        // Assigns implementations to the group which keeps most of its resources and the traffic within. Returns false if no group can host all of them.
+        bool place(const Hyperedges& implUids, const Hyperedges& groupUids, std::unordered_map< UniqueId, Hyperedges >& members, const std::size_t depth, Groups& groups, std::unordered_map< UniqueId, Hyperedges >& assigned)
+        {
+            const double total(objective.totalTraffic());
+            double bestScore(-std::numeric_limits<double>::infinity());
+            const UniqueId* bestGroupUid(NULL);
+            std::unordered_map< UniqueId, float > bestBooked;
+            for (const UniqueId& groupUid : groupUids)
+            {
+                const Hyperedges& availableUids(groups.availableUids[groupUid]);
+                // The aggregated resources have to suffice ...
+                std::unordered_map< UniqueId, float > booked;
+                bool fits(true);
+                for (const UniqueId& implUid : implUids)
+                    fits = fits && bookOn(model, consumedBy(model, implUid), availableUids, groups.residuals, booked);
+                if (!fits)
+                    continue;
+                // ... and every implementation needs some processor of the group which matches on its own and reaches the neighbours placed so far
+                bool matched(true);
+                for (const UniqueId& implUid : implUids)
+                {
+                    bool found(false);
+                    for (const UniqueId& procUid : members[groupUid])
+                    {
+                        if ((found = (Mapper::matchImplementationAndProcessor(model, implUid, procUid) >= 0.f) && reachesNeighbours(implUid, procUid, implUids, members[groupUid])))
+                            break;
+                    }
+                    if (!(matched = found))
+                        break;
+                }
+                if (!matched)
+                    continue;
+                // Keep as many resources as possible and the traffic within the group
+                const double slack((groups.slacks[groupUid] - fractionsOf(model, booked)) / std::max< std::size_t >(1, availableUids.size()));
+                double traffic(0.0);
+                for (const UniqueId& implUid : implUids)
+                {
+                    for (const UniqueId& neighbourUid : objective.neighboursOf(implUid))
+                    {
+                        const UniqueId& placedUid(placedIn(neighbourUid, depth));
+                        if (!placedUid.empty() && (placedUid != groupUid))
+                            traffic += objective.trafficBetween(implUid, neighbourUid);
+                    }
+                }
+                const double score(slack - (total > 0.0 ? commWeight * traffic / total : 0.0));
+                if (score > bestScore)
+                {
+                    bestScore = score;
+                    bestGroupUid = &groupUid;
+                    bestBooked.swap(booked);
+                }
+            }
+            // Implementations without a group are mapped by the final pass (see Mapper::mapHierarchically)
+            if (!bestGroupUid)
+                return false;
+            // Only the residuals of the chosen group change
+            for (const std::pair< const UniqueId, float >& entry : bestBooked)
+                groups.residuals[entry.first] -= entry.second;
+            groups.slacks[*bestGroupUid] -= fractionsOf(model, bestBooked);
+            for (const UniqueId& implUid : implUids)
+            {
+                assigned[*bestGroupUid].push_back(implUid);
+                placed[implUid] = *bestGroupUid;
+            }
+            return true;
+        }
+
+        // Returns the group of an implementation at the given depth (or nothing, if it has not been placed yet)
+        UniqueId placedIn(const UniqueId& implUid, const std::size_t depth) const
+        {
+            const Hyperedges& procUids(model.providersOf(Hyperedges{implUid}));
+            if (!procUids.empty() && paths.count(procUids[0]))
+                return groupOf(procUids[0], depth);
+            const auto& it(placed.find(implUid));
+            return (it != placed.end()) ? it->second : UniqueId();
+        }
+
+        // Checks if a processor can reach some processor of every neighbour which has been mapped or placed already (or is placed together with it onto the given processors)
+        bool reachesNeighbours(const UniqueId& implUid, const UniqueId& procUid, const Hyperedges& togetherUids, const Hyperedges& procUids) const
+        {
+            for (const UniqueId& neighbourUid : objective.neighboursOf(implUid))
+            {
+                Hyperedges targetUids(model.providersOf(Hyperedges{neighbourUid}));
+                if (targetUids.empty() && (std::find(togetherUids.begin(), togetherUids.end(), neighbourUid) != togetherUids.end()))
+                    targetUids = procUids;
+                if (targetUids.empty())
+                {
+                    const auto& it(placed.find(neighbourUid));
+                    if (it == placed.end())
+                        continue;
+                    targetUids = processorsIn.at(it->second);
+                }
+                bool reached(false);
+                for (const UniqueId& targetUid : targetUids)
+                {
+                    if ((reached = reachability.reachable(procUid, targetUid)))
+                        break;
+                }
+                if (!reached)
+                    return false;
+            }
+            return true;
+        }
+
+        const ResourceCost::Model& model;
+        const Reachability& reachability;
+        const CommunicationObjective& objective;
+        const double commWeight;
+        // The devices containing a processor (from the outermost one to the processor itself)
+        std::unordered_map< UniqueId, Hyperedges > paths;
+        // The processors contained in a device (or the processor itself)
+        std::unordered_map< UniqueId, Hyperedges > processorsIn;
+        // The last group an unmapped implementation has been assigned to
+        std::unordered_map< UniqueId, UniqueId > placed;
+};
+
+// Groups the given uids by the connected components of the reachability index (in order of their first uids)
+std::vector< Hyperedges > connectedComponentsOf(const Reachability& reachability, const Hyperedges& uids)
+{
+    std::vector< Hyperedges > result;
+    std::unordered_map< std::size_t, std::size_t > componentOf;
+    for (const UniqueId& uid : uids)
+    {
+        const int node(reachability.indexOf(uid));
+        if (node < 0)
+        {
+            // Not connected to anything
+            result.push_back(Hyperedges{uid});
+            continue;
+        }
+        const auto& it(componentOf.find(node));
+        if (it != componentOf.end())
+        {
+            result[it->second].push_back(uid);
+            continue;
+        }
+        // Label everything reachable by breadth-first search
+        const std::size_t component(result.size());
+        result.push_back(Hyperedges{uid});
+        std::vector< std::size_t > pending{static_cast< std::size_t >(node)};
+        componentOf[node] = component;
+        for (std::size_t i = 0; i < pending.size(); ++i)
+        {
+            for (const std::size_t neighbour : reachability.adjacentComponentsOf(pending[i]))
+            {
+                if (componentOf.count(neighbour))
+                    continue;
+                componentOf[neighbour] = component;
+                pending.push_back(neighbour);
+            }
+        }
+    }
+    return result;
 }
 
-Hyperedges Mapper::processors (const ResourceCost::Model& rcm)
+}
+
+float Mapper::mapHierarchically(const ResourceCost::Solver& solver)
 {
-    const ::Hardware::Computational::Network& hw(static_cast<const ResourceCost::Model&>(rcm));
-    return intersect(ResourceCost::Model::partitionFuncRight(rcm), hw.processors());
+    const ReachabilityScope scope(*this, hopLimit);
+    const CommunicationObjective communication(*this, activeReachability(), commWeight);
+
+    // I. Split the mapping along the device hierarchy
+    std::vector< Subproblem > subproblems;
+    {
+        Hierarchy hierarchy(*this, activeReachability(), communication, commWeight);
+        hierarchy.split(unmappedImplementations(*this), processors(*this), subproblems);
+    }
+    DIAGNOSE(Diagnostics::INFO, "HIERARCHY: " << subproblems.size() << " subproblems");
+
+    // II. Solve the subproblems in parallel
+    solveAll(*this, solver, subproblems, communication, numThreads);
+
+    // III. Map everything left over (e.g. because the resources of a group are fragmented) using all processors, then the interfaces
+    return map(solver);
 }
 
-Hyperedges Mapper::swInterfaces (const ResourceCost::Model& rcm)
+float Mapper::mapDecomposed(const ResourceCost::Solver& solver)
 {
-    const Software::Network& sw(static_cast<const ResourceCost::Model&>(rcm));
-    const Hyperedges& candidateInterfaces(intersect(ResourceCost::Model::partitionFuncLeft(rcm), sw.interfacesOf(implementations(rcm))));
-    // We remove all interfaces which are pure internal interfaces. These dont have to be mapped to hw interfaces
-    Hyperedges internalInterfaces;
-    for (const UniqueId& a : candidateInterfaces)
+    const ReachabilityScope scope(*this, hopLimit);
+    const Reachability& reachability(activeReachability());
+    const CommunicationObjective communication(*this, reachability, commWeight);
+
+    // I. Find the connected components of the sw and the hw
+    const std::vector< Hyperedges >& swComponents(connectedComponentsOf(reachability, unmappedImplementations(*this)));
+    const std::vector< Hyperedges >& hwComponents(connectedComponentsOf(reachability, processors(*this)));
+    std::vector< Hyperedges > availableUids(hwComponents.size());
+    std::unordered_map< UniqueId, float > residuals;
+    // Per hw component: the sum of the fractions of its resources which are left
+    std::vector< double > slacks(hwComponents.size(), 0.0);
+    for (std::size_t h = 0; h < hwComponents.size(); ++h)
     {
-        // Get targets of owner
-        const Hyperedges& swOwnerUids(sw.interfacesOf(Hyperedges{a},"",Hypergraph::TraversalDirection::INVERSE));
-        const Hyperedges& swTargetUids(rcm.providersOf(swOwnerUids));
-        // Get connected interfaces
-        const Hyperedges& swNeighbourInterfaceUids(sw.endpointsOf(Hyperedges{a},"",Hypergraph::TraversalDirection::BOTH));
-        // ... and their owners
-        const Hyperedges& swNeighbourOwnerUids(sw.interfacesOf(swNeighbourInterfaceUids,"",Hypergraph::TraversalDirection::INVERSE));
-        // ... and the targets of the owners
-        const Hyperedges& swNeighbourTargetUids(rcm.providersOf(swNeighbourOwnerUids));
-        // Check that each swNeighbourTargetUid is in swTargetUids
-        if (subtract(swNeighbourTargetUids, swTargetUids).size())
-            continue; // at least one target is different
-        std::cout << "PARTITION INTERFACES: Removing pure internal sw interface: " << a << "\n";
-        internalInterfaces.push_back(a);
+        availableUids[h] = resourcesOf(hwComponents[h]);
+        for (const UniqueId& resourceUid : availableUids[h])
+        {
+            residuals[resourceUid] = amountOf(resourceUid) - usageOf(resourceUid);
+            slacks[h] += residuals[resourceUid] / amountOf(resourceUid);
+        }
     }
-    return subtract(candidateInterfaces, internalInterfaces);
+
+    // II. A sw component has to stay within a hw component (otherwise its implementations cannot reach each other).
+    // So they are assigned greedily (largest demand first) to the hw component which keeps most of its resources.
+    std::vector< std::pair< float, std::size_t > > order;
+    for (std::size_t s = 0; s < swComponents.size(); ++s)
+    {
+        float demand(0.f);
+        for (const UniqueId& implUid : swComponents[s])
+        {
+            for (const UniqueId& consumedUid : consumedBy(*this, implUid))
+                demand += amountOf(consumedUid);
+        }
+        order.push_back(std::make_pair(demand, s));
+    }
+    std::stable_sort(order.begin(), order.end(), [] (const std::pair< float, std::size_t >& a, const std::pair< float, std::size_t >& b) { return a.first > b.first; });
+    std::vector< std::vector< std::size_t > > hosted(hwComponents.size());
+    for (const std::pair< float, std::size_t >& entry : order)
+    {
+        const Hyperedges& implUids(swComponents[entry.second]);
+        double bestSlack(-std::numeric_limits<double>::infinity());
+        std::size_t bestH(hwComponents.size());
+        std::unordered_map< UniqueId, float > bestBooked;
+        for (std::size_t h = 0; h < hwComponents.size(); ++h)
+        {
+            std::unordered_map< UniqueId, float > booked;
+            bool fits(true);
+            for (const UniqueId& implUid : implUids)
+                fits = fits && bookOn(*this, consumedBy(*this, implUid), availableUids[h], residuals, booked);
+            // With a single hw component, there is no choice
+            if (!fits && (hwComponents.size() > 1))
+                continue;
+            const double slack((slacks[h] - fractionsOf(*this, booked)) / std::max< std::size_t >(1, availableUids[h].size()));
+            if (slack > bestSlack)
+            {
+                bestSlack = slack;
+                bestH = h;
+                bestBooked.swap(booked);
+            }
+        }
+        // Components which fit nowhere are mapped by the final pass
+        if (bestH >= hwComponents.size())
+            continue;
+        // Only the residuals of the chosen hw component change
+        for (const std::pair< const UniqueId, float >& booking : bestBooked)
+            residuals[booking.first] -= booking.second;
+        slacks[bestH] -= fractionsOf(*this, bestBooked);
+        hosted[bestH].push_back(entry.second);
+    }
+
+    // III. The sw components hosted by the same hw component share its processors.
+    // Every one of them reserves the residuals of the consumed resources in proportion to its demands.
+    std::vector< Subproblem > subproblems;
+    for (std::size_t h = 0; h < hwComponents.size(); ++h)
+    {
+        if (hosted[h].size() == 1)
+            subproblems.push_back(Subproblem{swComponents[hosted[h][0]], hwComponents[h]});
+        if (hosted[h].size() < 2)
+            continue;
+        // The demand of every sw component for every resource (resources of the same classes are served alike)
+        std::map< std::string, std::vector< float > > demands;
+        std::unordered_map< UniqueId, std::string > classesOfResource;
+        for (const UniqueId& resourceUid : availableUids[h])
+        {
+            const std::string& classes(describeClasses(*this, resourceUid));
+            classesOfResource[resourceUid] = classes;
+            std::vector< float >& demand(demands[classes]);
+            if (!demand.empty())
+                continue;
+            demand.resize(hosted[h].size(), 0.f);
+            for (std::size_t i = 0; i < hosted[h].size(); ++i)
+            {
+                for (const UniqueId& implUid : swComponents[hosted[h][i]])
+                    demand[i] += consumedOf(implUid, resourceUid);
+            }
+        }
+        for (std::size_t i = 0; i < hosted[h].size(); ++i)
+        {
+            std::unordered_map< UniqueId, float > reserved;
+            for (const UniqueId& resourceUid : availableUids[h])
+            {
+                const std::vector< float >& demand(demands[classesOfResource[resourceUid]]);
+                const float total(std::accumulate(demand.begin(), demand.end(), 0.f));
+                // Resources which are not consumed (but only needed) are not reserved
+                if ((total <= 0.f) || (demand[i] <= 0.f))
+                    continue;
+                const float used(usageOf(resourceUid));
+                reserved[resourceUid] = used + (amountOf(resourceUid) - used) * demand[i] / total;
+            }
+            subproblems.push_back(Subproblem{swComponents[hosted[h][i]], hwComponents[h], reserved});
+        }
+    }
+    DIAGNOSE(Diagnostics::INFO, "DECOMPOSITION: " << swComponents.size() << " sw components, " << hwComponents.size() << " hw components, " << subproblems.size() << " subproblems");
+
+    // IV. Solve the subproblems in parallel
+    solveAll(*this, solver, subproblems, communication, numThreads);
+
+    // V. Map everything left over (e.g. because the reserved resources are fragmented) using all processors, then the interfaces
+    return map(solver);
 }
 
-Hyperedges Mapper::hwInterfaces (const ResourceCost::Model& rcm)
+std::size_t Mapper::poweredProcessors() const
 {
-    const ::Hardware::Computational::Network& hw(static_cast<const ResourceCost::Model&>(rcm));
-    return intersect(ResourceCost::Model::partitionFuncRight(rcm), hw.interfacesOf(processors(rcm)));
+    std::size_t result(0);
+    for (const UniqueId& procUid : processors(*this))
+    {
+        if (!intersect(consumersOf(Hyperedges{procUid}), implementations(*this)).empty())
+            ++result;
+    }
+    return result;
 }
 
-float Mapper::matchSwToHwInterface (const ResourceCost::Model& rcm, const UniqueId& a, const UniqueId& b)
+float Mapper::bottleneckSlack() const
 {
-    // We have two things to check:
-    // a) resource constraints (ResourceCost::Model::matchFunc)
-    const float costs(ResourceCost::Model::matchFunc(rcm, a, b));
-    if (costs < 0.f)
-        return costs;
+    float result(1.f);
+    for (const UniqueId& resourceUid : resourcesOf(processors(*this)))
+        result = std::min(result, (amountOf(resourceUid) - usageOf(resourceUid)) / amountOf(resourceUid));
+    return result;
+}
 
-    const Software::Network& sw(static_cast<const ResourceCost::Model&>(rcm));
-    const ::Hardware::Computational::Network& hw(static_cast<const ResourceCost::Model&>(rcm));
+std::vector< Mapper > Mapper::paretoFront(const ResourceCost::Solver& solver, const std::vector< double >& weights, const std::size_t maxLimits) const
+{
+    const ReachabilityScope scope(*this, hopLimit);
+    const Reachability& reachability(activeReachability());
 
-    // NEW
-    const Hyperedges& swOwnerUids(sw.interfacesOf(Hyperedges{a},"",Hypergraph::TraversalDirection::INVERSE));
-    const Hyperedges& hwOwnerUids(hw.interfacesOf(Hyperedges{b},"",Hypergraph::TraversalDirection::INVERSE));
-    const Hyperedges& swTargetUids(rcm.providersOf(swOwnerUids));
-    // RULE I: if owner of 'a' is not mapped at all, we fail
-    if (swTargetUids.empty())
+    // Power on the processors in breadth-first order of the hw network, so the powered ones stay connected
+    const Hyperedges& procUids(processors(*this));
+    Hyperedges orderedUids;
+    for (const Hyperedges& componentUids : connectedComponentsOf(reachability, procUids))
     {
-        std::cout << "REACH CHECK FAILED: sw interface: " << a << " hardware interface: " << b << " OWNER NOT MAPPED\n";
-        return -std::numeric_limits<float>::infinity();
+        const int start(reachability.indexOf(componentUids[0]));
+        if (start < 0)
+        {
+            orderedUids.push_back(componentUids[0]);
+            continue;
+        }
+        std::vector< std::size_t > pending{static_cast< std::size_t >(start)};
+        std::unordered_map< std::size_t, bool > visited{{pending[0], true}};
+        for (std::size_t i = 0; i < pending.size(); ++i)
+        {
+            if (std::find(componentUids.begin(), componentUids.end(), reachability.uidOf(pending[i])) != componentUids.end())
+                orderedUids.push_back(reachability.uidOf(pending[i]));
+            for (const std::size_t neighbour : reachability.adjacentComponentsOf(pending[i]))
+            {
+                if (visited[neighbour])
+                    continue;
+                visited[neighbour] = true;
+                pending.push_back(neighbour);
+            }
+        }
     }
-    // RULE II: Check if owner of 'b' is the target of owner of 'a'
-    if (subtract(swTargetUids, hwOwnerUids).size()) // Some entries in swTargetUids are not in hwOwnerUids
+
+    // The runs: every limit of powered processors (at most maxLimits, evenly spread) with every weight
+    std::vector< std::size_t > limits;
+    const std::size_t nLimits(std::max< std::size_t >(1, std::min(maxLimits, orderedUids.size())));
+    for (std::size_t i = 1; i <= nLimits; ++i)
     {
-        std::cout << "REACH CHECK FAILED: sw interface: " << a << " hardware interface: " << b << " OWNER MISMATCH\n";
-        return -std::numeric_limits<float>::infinity();
+        const std::size_t limit((i * orderedUids.size() + nLimits - 1) / nLimits);
+        if (limits.empty() || (limits.back() != limit))
+            limits.push_back(limit);
     }
-    // NOTE: We do not have to check for internal interfaces. They have been filtered by the partition function already
-    const Hyperedges& swNeighbourInterfaceUids(sw.endpointsOf(Hyperedges{a},"",Hypergraph::TraversalDirection::BOTH));
-    const Hyperedges& hwNeighbourInterfaceUids(hw.endpointsOf(Hyperedges{b},"",Hypergraph::TraversalDirection::BOTH));
-    const Hyperedges& swTargetInterfaceUids(rcm.providersOf(swNeighbourInterfaceUids));
-    // RULE III: Some of the connections are external or unmapped. Check if every hw interface of connected interfaces can be reached by 'b'
-    if (subtract(swTargetInterfaceUids, hwNeighbourInterfaceUids).size()) // Some x in swTargetInterfaceUids not in hwNeighbourInterfaceUids
+    std::vector< std::pair< std::size_t, double > > runs;
+    for (const std::size_t limit : limits)
     {
-        std::cout << "REACH CHECK FAILED: sw interface: " << a << " hardware interface: " << b << " ENDPOINTS UNREACHABLE\n";
-        return -std::numeric_limits<float>::infinity();
+        for (const double weight : weights)
+            runs.push_back(std::make_pair(limit, weight));
     }
-    const Hyperedges& swNeighbourOwnerUids(sw.interfacesOf(swNeighbourInterfaceUids,"",Hypergraph::TraversalDirection::INVERSE));
-    const Hyperedges& hwNeighbourOwnerUids(hw.interfacesOf(hwNeighbourInterfaceUids,"",Hypergraph::TraversalDirection::INVERSE));
-    const Hyperedges& swNeighbourTargetUids(rcm.providersOf(swNeighbourOwnerUids));
-    // RULE IV: If all remote interfaces are unmapped we are unable to verify reachability.
-    if (swNeighbourTargetUids.empty())
+
+    // Do all runs in parallel (every run maps its own copy)
+    std::vector< std::unique_ptr< Mapper > > candidates(runs.size());
+    std::atomic< std::size_t > next(0);
+    const unsigned int nWorkers(std::max(1u, std::min< unsigned int >(numThreads, runs.size())));
+    auto worker = [&] () {
+        const ReachabilityScope shared(reachability);
+        for (std::size_t k = next++; k < runs.size(); k = next++)
+        {
+            std::unique_ptr< Mapper > candidate(new Mapper(*this));
+            candidate->communicationWeight(runs[k].second);
+            const CommunicationObjective communication(*candidate, reachability, runs[k].second);
+            const std::vector< Subproblem > subproblems{Subproblem{unmappedImplementations(*candidate), Hyperedges(orderedUids.begin(), orderedUids.begin() + runs[k].first)}};
+            solveAll(*candidate, solver, subproblems, communication, 1);
+            // Only complete mappings are candidates
+            if (!unmappedImplementations(*candidate).empty())
+                continue;
+            candidate->mapAllSwAndHwInterfaces();
+            candidates[k] = std::move(candidate);
+        }
+    };
+    std::vector< std::thread > pool;
+    for (unsigned int i = 1; i < nWorkers; ++i)
+        pool.push_back(std::thread(worker));
+    worker();
+    for (std::thread& t : pool)
+        t.join();
+
+    // Keep the mappings which are not dominated by any other (or equal to an earlier one)
+    struct Measures
     {
-        std::cout << "REACH CHECK FAILED: sw interface: " << a << " hardware interface: " << b << " ENDPOINT OWNERS UNMAPPED\n";
-        return -std::numeric_limits<float>::infinity();
+        std::size_t powered;
+        float communication;
+        float slack;
+    };
+    std::vector< Measures > measures(runs.size());
+    for (std::size_t k = 0; k < runs.size(); ++k)
+    {
+        if (candidates[k])
+            measures[k] = Measures{candidates[k]->poweredProcessors(), candidates[k]->communicationCosts(), candidates[k]->bottleneckSlack()};
     }
-    // RULE V: owners of the endpoints of 'a' have to be mapped to the owners of the endpoints of 'b'
-    if (subtract(swNeighbourTargetUids, hwNeighbourOwnerUids).size()) // Some x in swNeighbourTargetUids not in hwNeighbourOwnerUids
+    std::vector< std::size_t > front;
+    for (std::size_t k = 0; k < runs.size(); ++k)
     {
-        std::cout << "REACH CHECK FAILED: sw interface: " << a << " hardware interface: " << b << " ENDPOINT OWNERS MISMATCH\n";
-        return -std::numeric_limits<float>::infinity();
+        if (!candidates[k])
+            continue;
+        bool dominated(false);
+        for (std::size_t j = 0; (j < runs.size()) && !dominated; ++j)
+        {
+            if ((j == k) || !candidates[j])
+                continue;
+            const Measures& a(measures[j]);
+            const Measures& b(measures[k]);
+            const bool noWorse((a.powered <= b.powered) && (a.communication <= b.communication) && (a.slack >= b.slack));
+            const bool better((a.powered < b.powered) || (a.communication < b.communication) || (a.slack > b.slack));
+            dominated = noWorse && (better || (j < k));
+        }
+        if (!dominated)
+            front.push_back(k);
     }
-    //std::cout << "REACH CHECK SUCCESSFUL sw interface: " << sw.access(a).label() << " hardware interface: " << hw.access(b).label() << " MATCH\n";
-    return costs;
+    std::stable_sort(front.begin(), front.end(), [&] (const std::size_t a, const std::size_t b) {
+        if (measures[a].powered != measures[b].powered)
+            return measures[a].powered < measures[b].powered;
+        if (measures[a].communication != measures[b].communication)
+            return measures[a].communication < measures[b].communication;
+        return measures[a].slack > measures[b].slack;
+    });
+    DIAGNOSE(Diagnostics::INFO, "PARETO FRONT: " << runs.size() << " runs, " << front.size() << " non-dominated mappings");
+    std::vector< Mapper > result;
+    for (const std::size_t k : front)
+        result.push_back(*candidates[k]);
+    return result;
 }
 
-float Mapper::matchImplementationAndProcessor (const ResourceCost::Model& rcm, const UniqueId& a, const UniqueId& b)
+float Mapper::map(const ResourceCost::Solver& solver)
 {
-    // We have two things to check:
-    // a) resource constraints (ResourceCost::Model::matchFunc)
-    const float costs(ResourceCost::Model::matchFunc(rcm, a, b));
-    if (costs < 0.f)
-        return costs;
+    // Both steps share the reachability index
+    const ReachabilityScope scope(*this, hopLimit);
+    const float globalCostsA(mapAllImplementationsToProcessors(solver));
+    if (globalCostsA < 0.f)
+        return globalCostsA;
+    const float globalCostsB(mapAllSwAndHwInterfaces());
+    if (globalCostsB < 0.f)
+        return globalCostsB;
+    return (globalCostsA + globalCostsB) / 2.f;
+}
 
-    const Software::Network& sw(static_cast<const ResourceCost::Model&>(rcm));
-    const ::Hardware::Computational::Network& hw(static_cast<const ResourceCost::Model&>(rcm));
-    // b) reachability constraints
-    // Lets check if all neighbours of a are mapped to neighbours of b or not mapped at all
-    const Hyperedges& swNeighbourUids(sw.interfacesOf(sw.endpointsOf(sw.interfacesOf(Hyperedges{a}),"", Hypergraph::TraversalDirection::BOTH),"",Hypergraph::TraversalDirection::INVERSE));
-    const Hyperedges& hwNeighbourUids(unite(hw.interfacesOf(hw.endpointsOf(hw.interfacesOf(Hyperedges{b}),"", Hypergraph::TraversalDirection::BOTH),"",Hypergraph::TraversalDirection::INVERSE), Hyperedges{b}));
-    const Hyperedges& swTargetUids(rcm.providersOf(swNeighbourUids));
-    // If any of the targets of sw neighbours is not in hw neighbours, we cannot reach that sw component
-    if (subtract(swTargetUids, hwNeighbourUids).size()) // Some owner of an endpoint of 'a' is not in the owners of the endpoints of 'b'
+std::string Mapper::hardwareHash() const
+{
+    const ReachabilityScope scope(*this, hopLimit);
+    const ::Hardware::Computational::NetworkView hw(*this);
+    // All devices and everything connected to them (like the reachability index)
+    std::vector< std::string > descriptions;
+    Hyperedges pendingUids(hw.devices());
+    std::unordered_map< UniqueId, bool > visited;
+    while (!pendingUids.empty())
     {
-        // Reachability constraint failed!
-        std::cout << "REACH CHECK FAILED: for consumer: " << sw.access(a).label() << " and provider: " << hw.access(b).label() << "\n";
-        return -std::numeric_limits<float>::infinity();
+        const UniqueId componentUid(pendingUids.back());
+        pendingUids.pop_back();
+        if (visited[componentUid])
+            continue;
+        visited[componentUid] = true;
+        descriptions.push_back(componentUid + ":" + describeClasses(*this, componentUid) + ":" + describeResources(*this, resourcesOf(Hyperedges{componentUid})) + describeInterfaces(*this, hw, activeReachability(), componentUid, false));
+        const Hyperedges& neighbourUids(hw.endpointsOf(hw.interfacesOf(Hyperedges{componentUid}), "", Hypergraph::TraversalDirection::BOTH));
+        for (const UniqueId& ownerUid : hw.interfacesOf(neighbourUids, "", Hypergraph::TraversalDirection::INVERSE))
+            pendingUids.push_back(ownerUid);
     }
-    return costs;
+    std::sort(descriptions.begin(), descriptions.end());
+    std::ostringstream description;
+    for (const std::string& componentDescription : descriptions)
+        description << componentDescription << "\n";
+    return hashOf(description.str());
 }
 
-void Mapper::mapSwToHwInterface (CommonConceptGraph& g, const UniqueId& a, const UniqueId& b)
+std::map< UniqueId, std::string > Mapper::implementationHashes() const
 {
-    ResourceCost::Model& rcm(static_cast< ResourceCost::Model& >(g));
-    // Map sw interface a to hw interface b
-    rcm.factFrom(Hyperedges{a}, Hyperedges{b}, Mapper::ReachableViaUid);
+    const ReachabilityScope scope(*this, hopLimit);
+    const Software::NetworkView sw(*this);
+    std::map< UniqueId, std::string > result;
+    for (const UniqueId& implUid : implementations(*this))
+        result[implUid] = hashOf(implUid + ":" + describeClasses(*this, implUid) + ":" + describeResources(*this, demandsOf(Hyperedges{implUid})) + describeInterfaces(*this, sw, activeReachability(), implUid, true));
+    return result;
 }
 
-void Mapper::mapImplementationToProcessor (CommonConceptGraph& g, const UniqueId& a, const UniqueId& b)
+std::string Mapper::canonicalHash(const std::string& salt) const
 {
-    ResourceCost::Model& rcm(static_cast< ResourceCost::Model& >(g));
-    // Map sw implementation a to processor b
-    rcm.factFrom(Hyperedges{a}, Hyperedges{b}, Mapper::ExecutedOnUid);
+    std::ostringstream description;
+    description << "hardware:" << hardwareHash() << "\n";
+    for (const std::map< UniqueId, std::string >::value_type& pair : implementationHashes())
+        description << pair.first << ":" << pair.second << "\n";
+    description << "hops:" << hopLimit << "\nweight:" << std::setprecision(17) << commWeight << "\nsalt:" << salt << "\n";
+    return hashOf(description.str());
 }
 
-/* Uses the implemented functions to map software implementations to hardware processors */
-float Mapper::mapAllImplementationsToProcessors()
+float Mapper::map(const ResourceCost::Solver& solver, const MappingCache& cache)
 {
-    // Perform mapping and import results
-    const ResourceCost::Model result(ResourceCost::Model::map(implementations, processors, matchImplementationAndProcessor, mapImplementationToProcessor));
-    importFrom(result);
+    const ReachabilityScope scope(*this, hopLimit);
+    const Software::NetworkView sw(*this);
+    const std::string& key(canonicalHash(solver.name()));
+    MappingCache::Entry entry;
+    float result(0.f);
+    if (cache.find(hardwareHash(), key, entry))
+    {
+        DIAGNOSE(Diagnostics::INFO, "MAPPING CACHE: restoring " << key);
+        for (const std::pair< UniqueId, UniqueId >& fact : entry.executedOn)
+            mapImplementationToProcessor(*this, fact.first, fact.second);
+        for (const std::pair< UniqueId, UniqueId >& fact : entry.reachableVia)
+            mapSwToHwInterface(*this, fact.first, fact.second);
+        // Same result as map() (the restored interfaces add no costs to the mean of both steps)
+        const float globalCostsA(globalCosts());
+        if (globalCostsA < 0.f)
+            return globalCostsA;
+        return (globalCostsA + 0.f) / 2.f;
+    }
 
-    // Check if every sw implementation could be mapped
-    const Hyperedges& implUids(implementations(result));
-    for (const UniqueId& implUid : implUids)
+    // Warm start: Keep the processors of unchanged implementations (as long as they still match)
+    const std::map< UniqueId, std::string >& implHashes(implementationHashes());
+    const std::size_t shared(cache.findSimilar(hardwareHash(), implHashes, entry));
+    if (shared > 0)
     {
-        if (!providersOf(Hyperedges{implUid}).size())
+        std::size_t kept(0);
+        for (const std::pair< UniqueId, UniqueId >& fact : entry.executedOn)
         {
-            std::cout << "COMPLETENESS CHECK FAILED: " << access(implUid).label() << " has no provider\n";
-            return -std::numeric_limits<float>::infinity();
+            std::map< UniqueId, std::string >::const_iterator it(implHashes.find(fact.first));
+            if ((it == implHashes.end()) || (entry.implementationHashes[fact.first] != it->second))
+                continue;
+            if (!providersOf(Hyperedges{fact.first}).empty() || (matchImplementationAndProcessor(*this, fact.first, fact.second) < 0.f))
+                continue;
+            mapImplementationToProcessor(*this, fact.first, fact.second);
+            ++kept;
         }
+        DIAGNOSE(Diagnostics::INFO, "MAPPING CACHE: warm start, kept " << kept << " of " << implHashes.size() << " implementations");
     }
+    result = map(solver);
 
-    // Calculate global costs
-    float globalCosts(0.f);
-    const Hyperedges& hwUids(processors(result));
-    for (const UniqueId& hwUid : hwUids)
+    // Store the result
+    entry = MappingCache::Entry();
+    entry.hardwareHash = hardwareHash();
+    entry.implementationHashes = implHashes;
+    for (const UniqueId& implUid : implementations(*this))
     {
-        const Hyperedges& swUids(consumersOf(Hyperedges{hwUid}));
-        const Hyperedges& availableResourceUids(resourcesOf(Hyperedges{hwUid}));
-        const Hyperedges& consumedResourceUids(swUids.size() > 0 ? isPointingTo(factsOf(subrelationsOf(Hyperedges{ResourceCost::Model::ConsumesUid}), swUids)) : Hyperedges());
-        for (const UniqueId& availableResourceUid : availableResourceUids)
+        for (const UniqueId& hwUid : providersOf(Hyperedges{implUid}))
+            entry.executedOn.push_back(std::make_pair(implUid, hwUid));
+    }
+    for (const UniqueId& swUid : sw.interfacesOf(implementations(*this)))
+    {
+        for (const UniqueId& hwUid : providersOf(Hyperedges{swUid}))
+            entry.reachableVia.push_back(std::make_pair(swUid, hwUid));
+    }
+    if (!cache.store(key, entry))
+        DIAGNOSE(Diagnostics::WARNING, "MAPPING CACHE: cannot store " << key);
+    return result;
+}
+
+// FeasibleImplementationNetworks
+FeasibleImplementationNetworks::FeasibleImplementationNetworks(const Software::Network& algorithmNetwork,
+                                                               const ResourceCost::Model& rcm,
+                                                               const ::Hardware::Computational::Network& hw)
+: Software::ImplementationNetworks(algorithmNetwork), numPruned(0)
+{
+    const Hyperedges& processorUids(intersect(ResourceCost::Model::partitionFuncRight(rcm), hw.processors()));
+    Hyperedges resourceUids;
+    for (const UniqueId& processorUid : processorUids)
+        resourceUids = unite(resourceUids, rcm.resourcesOf(Hyperedges{processorUid}));
+
+    // I. Check every implementation class against every processor and group its consumed demands by the resources which can serve them
+    std::map< std::vector< std::size_t >, std::size_t > groups;
+    std::vector< std::vector< std::vector< std::pair< std::size_t, float > > > > demands(algorithmUids.size());
+    fitting.resize(algorithmUids.size());
+    for (std::size_t i = 0; i < algorithmUids.size(); ++i)
+    {
+        for (const UniqueId& implClassUid : implementationClassUids[i])
         {
-            const float available(std::stof(access(availableResourceUid).label()));
-            const Hyperedges& availableResourceClassUids(instancesOf(Hyperedges{availableResourceUid}, "", FORWARD));
-            // Calculate already consumed resources
-            float used = 0.f;
-            for (const UniqueId& consumedResourceUid : consumedResourceUids)
+            const Hyperedges& consumerUids(rcm.exists(implClassUid) ? rcm.subclassesOf(Hyperedges{implClassUid}, "", Hypergraph::FORWARD) : Hyperedges());
+            const Hyperedges& demandUids(rcm.demandsOf(consumerUids));
+            bool fits(demandUids.empty() && !processorUids.empty());
+            for (std::size_t p = 0; (p < processorUids.size()) && !fits; ++p)
+                fits = (rcm.satisfies(Hyperedges{processorUids[p]}, consumerUids) >= 0.f);
+            fitting[i].push_back(fits);
+            demands[i].push_back(std::vector< std::pair< std::size_t, float > >());
+            const Hyperedges& consumedUids(intersect(demandUids, rcm.relatedTo(consumerUids, Hyperedges{ResourceCost::Model::ConsumesUid}, "", Hypergraph::FORWARD)));
+            for (const UniqueId& consumedUid : consumedUids)
             {
-                const Hyperedges& consumedResourceClassUids(instancesOf(Hyperedges{consumedResourceUid}, "", FORWARD));
-                // If types mismatch, continue
-                if (intersect(availableResourceClassUids, consumedResourceClassUids).empty())
-                    continue;
-                // Update usage
-                used += std::stof(access(consumedResourceUid).label());
+                std::vector< std::size_t > servers;
+                for (std::size_t k = 0; k < resourceUids.size(); ++k)
+                {
+                    if (rcm.compatible(consumedUid, resourceUids[k]))
+                        servers.push_back(k);
+                }
+                const auto& group(groups.insert(std::make_pair(servers, groups.size())).first);
+                demands[i].back().push_back(std::make_pair(group->second, rcm.amountOf(consumedUid)));
+                if (group->second == capacities.size())
+                {
+                    float capacity(0.f);
+                    for (const std::size_t k : servers)
+                        capacity += rcm.amountOf(resourceUids[k]) - rcm.usageOf(resourceUids[k]);
+                    capacities.push_back(capacity);
+                }
             }
-            globalCosts += (available - used) / available;
         }
     }
-    // NOTE: Greater means better :)
-    return (hwUids.size() > 0 ? globalCosts / hwUids.size() : 0.f);
+
+    // II. Sum up the consumption per group and find the least consumption of the remaining algorithms
+    consumption.resize(algorithmUids.size());
+    remaining.assign(algorithmUids.size() + 1, std::vector< float >(capacities.size(), 0.f));
+    for (std::size_t i = algorithmUids.size(); i > 0; --i)
+    {
+        std::vector< float > least(capacities.size(), std::numeric_limits< float >::infinity());
+        for (std::size_t c = 0; c < demands[i-1].size(); ++c)
+        {
+            consumption[i-1].push_back(std::vector< float >(capacities.size(), 0.f));
+            for (const std::pair< std::size_t, float >& demand : demands[i-1][c])
+                consumption[i-1][c][demand.first] += demand.second;
+            if (!fitting[i-1][c])
+                continue;
+            for (std::size_t g = 0; g < capacities.size(); ++g)
+                least[g] = std::min(least[g], consumption[i-1][c][g]);
+        }
+        for (std::size_t g = 0; g < capacities.size(); ++g)
+            remaining[i-1][g] = remaining[i][g] + (std::isinf(least[g]) ? 0.f : least[g]);
+    }
+
+    // III. Search
+    search(0, 0, std::vector< float >(capacities.size(), 0.f));
+    DIAGNOSE(Diagnostics::INFO, "FEASIBILITY: " << feasibleIndices.size() << " of " << size() << " implementation networks remain, " << numPruned << " subtrees cut");
 }
 
-float Mapper::mapAllSwAndHwInterfaces()
+const std::vector< std::size_t >& FeasibleImplementationNetworks::feasible() const
 {
-    // Perform mapping and import results
-    const ResourceCost::Model result(ResourceCost::Model::map(swInterfaces, hwInterfaces, matchSwToHwInterface, mapSwToHwInterface));
-    importFrom(result);
+    return feasibleIndices;
+}
 
-    return 0.f;
+std::size_t FeasibleImplementationNetworks::pruned() const
+{
+    return numPruned;
 }
 
-float Mapper::map()
+void FeasibleImplementationNetworks::search(const std::size_t algorithm, const std::size_t index, const std::vector< float >& consumed)
 {
-    const float globalCostsA(mapAllImplementationsToProcessors());
-    if (globalCostsA < 0.f)
-        return globalCostsA;
-    const float globalCostsB(mapAllSwAndHwInterfaces());
-    if (globalCostsB < 0.f);
-        return globalCostsB;
-    return (globalCostsA + globalCostsB) / 2.f;
+    if (algorithm == algorithmUids.size())
+    {
+        feasibleIndices.push_back(index);
+        return;
+    }
+    const std::size_t radix(implementationClassUids[algorithm].size());
+    for (std::size_t c = 0; c < radix; ++c)
+    {
+        // The implementation has to fit on some processor ...
+        if (!fitting[algorithm][c])
+        {
+            ++numPruned;
+            continue;
+        }
+        // ... and the consumption of all implementations (chosen or not) has to fit on all processors
+        std::vector< float > next(consumed);
+        bool fits(true);
+        for (std::size_t g = 0; (g < capacities.size()) && fits; ++g)
+        {
+            next[g] += consumption[algorithm][c][g];
+            fits = (next[g] + remaining[algorithm + 1][g] <= capacities[g]);
+        }
+        if (!fits)
+        {
+            ++numPruned;
+            continue;
+        }
+        search(algorithm + 1, index * radix + c, next);
+    }
 }
 
 }
 }
-
@@ -1,7 +1,95 @@
 #include "ResourceCostModel.hpp"
+#include "Diagnostics.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+#include <thread>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define RESOURCE_COST_AVX2
+#endif
 
 namespace ResourceCost {
 
+// Amounts are stored with enough digits to restore the exact float value
+static std::string amountToLabel(const float amount)
+{
+    std::ostringstream label;
+    label << std::setprecision(std::numeric_limits<float>::max_digits10) << amount;
+    return label.str();
+}
+
+static float labelToAmount(const std::string& label)
+{
+    return std::strtof(label.c_str(), NULL);
+}
+
+// Computes slack[p] = min(1, min_i((residuals[t_i][p] - demands[i]) / capacities[t_i][p])) for all providers p
+static void fitsScalar(const float* residuals, const float* capacities, const std::size_t stride,
+                       const std::vector< std::size_t >& rows, const std::vector< float >& demands, float* slack)
+{
+    for (std::size_t p = 0; p < stride; ++p)
+        slack[p] = 1.f;
+    for (std::size_t i = 0; i < rows.size(); ++i)
+    {
+        const float* residual(residuals + rows[i] * stride);
+        const float* capacity(capacities + rows[i] * stride);
+        for (std::size_t p = 0; p < stride; ++p)
+            slack[p] = std::min(slack[p], (residual[p] - demands[i]) / capacity[p]);
+    }
+}
+
+#ifdef RESOURCE_COST_AVX2
+// Same as fitsScalar() for 8 providers at once (stride has to be a multiple of 8)
+__attribute__((target("avx2")))
+static void fitsAVX2(const float* residuals, const float* capacities, const std::size_t stride,
+                     const std::vector< std::size_t >& rows, const std::vector< float >& demands, float* slack)
+{
+    for (std::size_t p = 0; p < stride; p += 8)
+    {
+        __m256 minimum(_mm256_set1_ps(1.f));
+        for (std::size_t i = 0; i < rows.size(); ++i)
+        {
+            const __m256 residual(_mm256_loadu_ps(residuals + rows[i] * stride + p));
+            const __m256 capacity(_mm256_loadu_ps(capacities + rows[i] * stride + p));
+            const __m256 cost(_mm256_div_ps(_mm256_sub_ps(residual, _mm256_set1_ps(demands[i])), capacity));
+            // NOTE: Like std::min(minimum, cost), a NaN cost keeps the minimum
+            minimum = _mm256_min_ps(cost, minimum);
+        }
+        _mm256_storeu_ps(slack + p, minimum);
+    }
+}
+#endif
+
+static void fitsKernel(const float* residuals, const float* capacities, const std::size_t stride,
+                       const std::vector< std::size_t >& rows, const std::vector< float >& demands, float* slack)
+{
+#ifdef RESOURCE_COST_AVX2
+    static const bool avx2(__builtin_cpu_supports("avx2"));
+    if (avx2)
+    {
+        fitsAVX2(residuals, capacities, stride, rows, demands, slack);
+        return;
+    }
+#endif
+    fitsScalar(residuals, capacities, stride, rows, demands, slack);
+}
+
+// Counts a rejection by the packed matrices (they do not know the details, so nothing is written)
+static float counted(const float score)
+{
+#ifndef DIAGNOSTICS_DISABLED
+    if (score < 0.f)
+        Diagnostics::count(std::isinf(score) ? Diagnostics::SAT_NO_RESOURCES : Diagnostics::SAT_INSUFFICIENT);
+#endif
+    return score;
+}
+
 const UniqueId Model::ConsumerUid = "ResourceCost::Model::Consumer";
 const UniqueId Model::ProviderUid = "ResourceCost::Model::Provider";
 const UniqueId Model::ResourceUid = "ResourceCost::Model::Resource";
@@ -25,20 +113,45 @@ void Model::setupMetaModel()
 }
 
 Model::Model()
+: resourceClassWords(0), packedMode(false), packedRows(0), packedProviderStride(0), packedStamp(0)
 {
     setupMetaModel();
 }
 
 Model::Model(const Hypergraph& A)
-: CommonConceptGraph(A)
+: CommonConceptGraph(A), resourceClassWords(0), packedMode(false), packedRows(0), packedProviderStride(0), packedStamp(0)
 {
     setupMetaModel();
+    indexResources();
 }
 
 Model::~Model()
 {
 }
 
+// RunContext
+static thread_local const RunContext* currentRunContext(NULL);
+
+RunContext::~RunContext()
+{
+}
+
+const RunContext* RunContext::current()
+{
+    return currentRunContext;
+}
+
+RunContext::Scope::Scope(const RunContext* context)
+: previous(currentRunContext)
+{
+    currentRunContext = context;
+}
+
+RunContext::Scope::~Scope()
+{
+    currentRunContext = previous;
+}
+
 Hyperedges Model::defineResource(const UniqueId& uid, const std::string& name, const Hyperedges& superResourceUids)
 {
     const Hyperedges& all(subclassesOf(Hyperedges{Model::ResourceUid}));
@@ -50,7 +163,180 @@ Hyperedges Model::defineResource(const UniqueId& uid, const std::string& name, c
 Hyperedges Model::instantiateResource(const Hyperedges& resourceUids, const float amount)
 {
     const Hyperedges& validResourceUids(intersect(resourceUids, subclassesOf(Hyperedges{Model::ResourceUid})));
-    return instantiateFrom(validResourceUids, std::to_string(amount));
+    const Hyperedges& resourceInstanceUids(instantiateFrom(validResourceUids, amountToLabel(amount)));
+    for (const UniqueId& resourceInstanceUid : resourceInstanceUids)
+    {
+        resourceAmounts[slotOf(resourceInstanceUid)] = amount;
+    }
+    return resourceInstanceUids;
+}
+
+std::size_t Model::slotOf(const UniqueId& resourceUid)
+{
+    const auto& it(resourceSlots.find(resourceUid));
+    if (it != resourceSlots.end())
+        return it->second;
+    // Register the classes first (this might widen the bitsets)
+    std::vector< std::size_t > classIds;
+    std::vector< std::size_t > superclassIds;
+    const Hyperedges& classUids(instancesOf(Hyperedges{resourceUid}, "", FORWARD));
+    for (const UniqueId& classUid : classUids)
+        classIds.push_back(registerResourceClass(classUid));
+    const Hyperedges& superclassUids(compatibleClassesOf(resourceUid));
+    for (const UniqueId& superclassUid : superclassUids)
+        superclassIds.push_back(registerResourceClass(superclassUid));
+    // Create the new slot
+    const std::size_t slot(resourceAmounts.size());
+    resourceSlots[resourceUid] = slot;
+    resourceAmounts.push_back(labelToAmount(access(resourceUid).label()));
+    resourceUsages.push_back(0.f);
+    resourceClassBits.resize(resourceAmounts.size() * resourceClassWords, 0);
+    resourceSuperclassBits.resize(resourceAmounts.size() * resourceClassWords, 0);
+    for (const std::size_t classId : classIds)
+        resourceClassBits[slot * resourceClassWords + classId / 64] |= (std::uint64_t(1) << (classId % 64));
+    for (const std::size_t superclassId : superclassIds)
+        resourceSuperclassBits[slot * resourceClassWords + superclassId / 64] |= (std::uint64_t(1) << (superclassId % 64));
+    return slot;
+}
+
+std::size_t Model::registerResourceClass(const UniqueId& resourceClassUid)
+{
+    const auto& it(resourceClassIds.find(resourceClassUid));
+    if (it != resourceClassIds.end())
+        return it->second;
+    const std::size_t classId(resourceClassIds.size());
+    resourceClassIds[resourceClassUid] = classId;
+    // Widen the bitsets of all slots if necessary
+    const std::size_t words(classId / 64 + 1);
+    if (words > resourceClassWords)
+    {
+        std::vector< std::uint64_t > classBits(resourceAmounts.size() * words, 0);
+        std::vector< std::uint64_t > superclassBits(resourceAmounts.size() * words, 0);
+        for (std::size_t slot = 0; slot < resourceAmounts.size(); ++slot)
+        {
+            for (std::size_t word = 0; word < resourceClassWords; ++word)
+            {
+                classBits[slot * words + word] = resourceClassBits[slot * resourceClassWords + word];
+                superclassBits[slot * words + word] = resourceSuperclassBits[slot * resourceClassWords + word];
+            }
+        }
+        resourceClassBits.swap(classBits);
+        resourceSuperclassBits.swap(superclassBits);
+        resourceClassWords = words;
+    }
+    return classId;
+}
+
+int Model::resourceClassIdOf(const UniqueId& resourceClassUid) const
+{
+    const auto& it(resourceClassIds.find(resourceClassUid));
+    if (it != resourceClassIds.end())
+        return static_cast<int>(it->second);
+    return -1;
+}
+
+Hyperedges Model::compatibleClassesOf(const UniqueId& resourceUid) const
+{
+    const Hyperedges& classUids(instancesOf(Hyperedges{resourceUid}, "", FORWARD));
+    return unite(classUids, subtract(subclassesOf(classUids, "", FORWARD), Hyperedges{Model::ResourceUid}));
+}
+
+bool Model::compatible(const UniqueId& neededResourceUid, const UniqueId& availableResourceUid) const
+{
+    const auto& neededIt(resourceSlots.find(neededResourceUid));
+    const auto& availableIt(resourceSlots.find(availableResourceUid));
+    if ((neededIt == resourceSlots.end()) || (availableIt == resourceSlots.end()))
+    {
+        // Not in the ledger (yet), so we have to ask the graph
+        return !intersect(compatibleClassesOf(availableResourceUid), instancesOf(Hyperedges{neededResourceUid}, "", FORWARD)).empty();
+    }
+    // Some class of the needed resource has to be a (super)class of the available resource
+    const std::size_t neededOffset(neededIt->second * resourceClassWords);
+    const std::size_t availableOffset(availableIt->second * resourceClassWords);
+    for (std::size_t word = 0; word < resourceClassWords; ++word)
+    {
+        if (resourceClassBits[neededOffset + word] & resourceSuperclassBits[availableOffset + word])
+            return true;
+    }
+    return false;
+}
+
+float Model::amountOf(const UniqueId& resourceUid) const
+{
+    const auto& it(resourceSlots.find(resourceUid));
+    if (it != resourceSlots.end())
+        return resourceAmounts[it->second];
+    // Not in the ledger (yet), so we have to fall back to the label
+    return labelToAmount(access(resourceUid).label());
+}
+
+void Model::amountOf(const UniqueId& resourceUid, const float amount)
+{
+    access(resourceUid).label(amountToLabel(amount));
+    resourceAmounts[slotOf(resourceUid)] = amount;
+    unpack();
+}
+
+float Model::usageOf(const UniqueId& resourceUid) const
+{
+    const auto& it(resourceSlots.find(resourceUid));
+    if (it != resourceSlots.end())
+        return resourceUsages[it->second];
+    return 0.f;
+}
+
+void Model::indexResources()
+{
+    unpack();
+    resourceSlots.clear();
+    resourceAmounts.clear();
+    resourceUsages.clear();
+    resourceClassIds.clear();
+    resourceClassWords = 0;
+    resourceClassBits.clear();
+    resourceSuperclassBits.clear();
+    const Hyperedges& resourceInstanceUids(instancesOf(subclassesOf(Hyperedges{Model::ResourceUid})));
+    resourceAmounts.reserve(resourceInstanceUids.size());
+    resourceUsages.reserve(resourceInstanceUids.size());
+    for (const UniqueId& resourceInstanceUid : resourceInstanceUids)
+    {
+        slotOf(resourceInstanceUid);
+    }
+    // Book the consumption of already mapped consumers
+    const Hyperedges& consumerUids(unite(consumerClasses(), consumers()));
+    for (const UniqueId& consumerUid : consumerUids)
+    {
+        const Hyperedges& providerUids(providersOf(Hyperedges{consumerUid}));
+        for (const UniqueId& providerUid : providerUids)
+        {
+            book(consumerUid, providerUid);
+        }
+    }
+}
+
+float Model::consumedOf(const UniqueId& consumerUid, const UniqueId& availableResourceUid) const
+{
+    const Hyperedges& consumedResourceUids(isPointingTo(factsOf(subrelationsOf(Hyperedges{Model::ConsumesUid}), Hyperedges{consumerUid})));
+    float used = 0.f;
+    for (const UniqueId& consumedResourceUid : consumedResourceUids)
+    {
+        // If types mismatch, continue
+        if (!compatible(consumedResourceUid, availableResourceUid))
+            continue;
+        used += amountOf(consumedResourceUid);
+    }
+    return used;
+}
+
+void Model::book(const UniqueId& consumerUid, const UniqueId& providerUid, const float sign)
+{
+    const Hyperedges& availableResourceUids(resourcesOf(Hyperedges{providerUid}));
+    for (const UniqueId& availableResourceUid : availableResourceUids)
+    {
+        const float used(consumedOf(consumerUid, availableResourceUid));
+        resourceUsages[slotOf(availableResourceUid)] += sign * used;
+    }
+    repack(providerUid);
 }
 
 Hyperedges Model::isConsumer(const Hyperedges& consumerUids)
@@ -98,6 +384,7 @@ Hyperedges Model::needs(const Hyperedges& consumerUids, const Hyperedges& resour
             result = unite(result, factFrom(Hyperedges{fromId}, Hyperedges{toId}, Model::NeedsUid));
         }
     }
+    unpack();
     return result;
 }
 
@@ -113,6 +400,7 @@ Hyperedges Model::provides(const Hyperedges& providerUids, const Hyperedges& res
             result = unite(result, factFrom(Hyperedges{fromId}, Hyperedges{toId}, Model::ProvidesUid));
         }
     }
+    unpack();
     return result;
 }
 
@@ -128,6 +416,7 @@ Hyperedges Model::consumes(const Hyperedges& consumerUids, const Hyperedges& res
             result = unite(result, factFrom(Hyperedges{fromId}, Hyperedges{toId}, Model::ConsumesUid));
         }
     }
+    unpack();
     return result;
 }
 
@@ -155,6 +444,44 @@ Hyperedges Model::providersOf(const Hyperedges& consumerUids) const
     return relatedTo(consumerUids, Hyperedges{Model::MappedToUid},"", FORWARD);
 }
 
+Hyperedges Model::mapTo(const Hyperedges& consumerUids, const Hyperedges& providerUids, const UniqueId& relationUid)
+{
+    Hyperedges result;
+    for (const UniqueId& consumerUid : consumerUids)
+    {
+        for (const UniqueId& providerUid : providerUids)
+        {
+            const Hyperedges& factUids(factFrom(Hyperedges{consumerUid}, Hyperedges{providerUid}, relationUid));
+            if (factUids.empty())
+                continue;
+            book(consumerUid, providerUid);
+            result = unite(result, factUids);
+        }
+    }
+    return result;
+}
+
+Hyperedges Model::unmap(const Hyperedges& consumerUids)
+{
+    Hyperedges result;
+    const Hyperedges& relationUids(subrelationsOf(Hyperedges{Model::MappedToUid}));
+    for (const UniqueId& consumerUid : consumerUids)
+    {
+        const Hyperedges& factUids(factsOf(relationUids, Hyperedges{consumerUid}));
+        for (const UniqueId& factUid : factUids)
+        {
+            const Hyperedges& providerUids(isPointingTo(Hyperedges{factUid}));
+            for (const UniqueId& providerUid : providerUids)
+            {
+                book(consumerUid, providerUid, -1.f);
+            }
+            destroy(factUid);
+            result = unite(result, providerUids);
+        }
+    }
+    return result;
+}
+
 float Model::satisfies(const Hyperedges& providerUids, const Hyperedges& consumerUids) const
 {
     float minimum(1.0f);
@@ -169,35 +496,21 @@ float Model::satisfies(const Hyperedges& providerUids, const Hyperedges& consume
         {
             // Collect available resources of provider
             const Hyperedges& availableResourceUids(resourcesOf(Hyperedges{providerUid}));
-            // ... by also taking into account potential consumers of that resource
-            const Hyperedges& mappedConsumerUids(consumersOf(Hyperedges{providerUid}));
-            const Hyperedges& consumedResourceUids(mappedConsumerUids.size() ? isPointingTo(factsOf(subrelationsOf(Hyperedges{Model::ConsumesUid}), mappedConsumerUids)) : Hyperedges());
             for (const UniqueId& neededResourceUid : neededResourceUids)
             {
                 // Get amount of needed resources (demand)
-                const float needed(std::stof(access(neededResourceUid).label()));
-                const Hyperedges& neededResourceClassUids(instancesOf(Hyperedges{neededResourceUid}, "", FORWARD));
+                const float needed(amountOf(neededResourceUid));
                 bool matched = false;
                 for (const UniqueId& availableResourceUid : availableResourceUids)
                 {
-                    // Get amount of available resources
-                    const float available(std::stof(access(availableResourceUid).label()));
-                    const Hyperedges& availableResourceClassUids(instancesOf(Hyperedges{availableResourceUid}, "", FORWARD));
                     // If types mismatch, continue
-                    if (intersect(availableResourceClassUids, neededResourceClassUids).empty())
+                    if (!compatible(neededResourceUid, availableResourceUid))
                         continue;
+                    // Get amount of available resources
+                    const float available(amountOf(availableResourceUid));
                     // When we are here, we have found a matching pair of resources
-                    // Calculate already consumed resources
-                    float used = 0.f;
-                    for (const UniqueId& consumedResourceUid : consumedResourceUids)
-                    {
-                        const Hyperedges& consumedResourceClassUids(instancesOf(Hyperedges{consumedResourceUid}, "", FORWARD));
-                        // If types mismatch, continue
-                        if (intersect(availableResourceClassUids, consumedResourceClassUids).empty())
-                            continue;
-                        // Update usage
-                        used += std::stof(access(consumedResourceUid).label());
-                    }
+                    // Get already consumed resources (booked by previous mappings)
+                    const float used(usageOf(availableResourceUid));
                     // Calculate a quantity which reflects the amount of resources consumed
                     // A very small value stands for a high amount of resources needed
                     // A high value (<= 1) stands for a low amount of resources needed
@@ -209,7 +522,7 @@ float Model::satisfies(const Hyperedges& providerUids, const Hyperedges& consume
                     // NOTE: Even if the new consumer would consume the resource, we just check this constraint to handle both, existential and consumable resources
                     if (cost < 0.f)
                     {
-                        std::cout << "SAT-CHECK FAILED: Available: " << available << " Used: " << used << " Needed: " << needed << "\n";
+                        DIAGNOSE_RULE(Diagnostics::SAT_INSUFFICIENT, Diagnostics::DEBUG, "SAT-CHECK FAILED: Available: " << available << " Used: " << used << " Needed: " << needed);
                         return cost;
                     }
                     // When we are here, the demands have been fullfilled!!! That means, we can leave the loop and check another demand.
@@ -220,7 +533,7 @@ float Model::satisfies(const Hyperedges& providerUids, const Hyperedges& consume
                 if (!matched)
                 {
                     // If not, we are done :/
-                    std::cout << "SAT-CHECK FAILED: No resources found for " << neededResourceUid << "\n";
+                    DIAGNOSE_RULE(Diagnostics::SAT_NO_RESOURCES, Diagnostics::DEBUG, "SAT-CHECK FAILED: No resources found for " << neededResourceUid);
                     return -std::numeric_limits<float>::infinity();
                 }
             }
@@ -229,6 +542,276 @@ float Model::satisfies(const Hyperedges& providerUids, const Hyperedges& consume
     return minimum;
 }
 
+void Model::pack(const Hyperedges& consumerUids, const Hyperedges& providerUids)
+{
+    unpack();
+    packedConsumerUids = consumerUids;
+    packedProviderUids = providerUids;
+    // Slot all resources first (this registers all classes we need)
+    std::vector< std::vector< std::size_t > > demandSlots(consumerUids.size());
+    std::vector< std::vector< std::size_t > > providerSlots(providerUids.size());
+    for (std::size_t c = 0; c < consumerUids.size(); ++c)
+    {
+        packedConsumerColumns[consumerUids[c]] = c;
+        for (const UniqueId& neededResourceUid : demandsOf(Hyperedges{consumerUids[c]}))
+            demandSlots[c].push_back(slotOf(neededResourceUid));
+    }
+    for (std::size_t p = 0; p < providerUids.size(); ++p)
+    {
+        packedProviderColumns[providerUids[p]] = p;
+        for (const UniqueId& availableResourceUid : resourcesOf(Hyperedges{providerUids[p]}))
+            providerSlots[p].push_back(slotOf(availableResourceUid));
+    }
+    packedRows = resourceClassIds.size();
+    packedProviderStride = (providerUids.size() + 7) / 8 * 8;
+
+    // Providers: For every class, the first available resource which can serve a demand of that class is used (like in satisfies())
+    packedSlots.assign(packedRows * packedProviderStride, -1);
+    packedCapacities.assign(packedRows * packedProviderStride, 0.f);
+    packedResiduals.assign(packedRows * packedProviderStride, -std::numeric_limits<float>::infinity());
+    for (std::size_t p = 0; p < providerUids.size(); ++p)
+    {
+        for (const std::size_t slot : providerSlots[p])
+        {
+            for (std::size_t row = 0; row < packedRows; ++row)
+            {
+                const std::size_t idx(row * packedProviderStride + p);
+                if (packedSlots[idx] >= 0)
+                    continue;
+                if (!(resourceSuperclassBits[slot * resourceClassWords + row / 64] & (std::uint64_t(1) << (row % 64))))
+                    continue;
+                packedSlots[idx] = static_cast<long>(slot);
+                packedCapacities[idx] = resourceAmounts[slot];
+                packedResiduals[idx] = resourceAmounts[slot] - resourceUsages[slot];
+            }
+        }
+    }
+
+    // Consumers: Several demands of the same class are checked against the same resource, so only the biggest one matters
+    packedDemands.assign(packedRows * consumerUids.size(), -1.f);
+    packedConsumerValid.assign(consumerUids.size(), true);
+    for (std::size_t c = 0; c < consumerUids.size(); ++c)
+    {
+        for (const std::size_t slot : demandSlots[c])
+        {
+            long demandRow(-1);
+            for (std::size_t row = 0; row < packedRows; ++row)
+            {
+                if (!(resourceClassBits[slot * resourceClassWords + row / 64] & (std::uint64_t(1) << (row % 64))))
+                    continue;
+                if (demandRow >= 0)
+                {
+                    // A demand of several classes could be served by different resources, so we leave it to satisfies()
+                    packedConsumerValid[c] = false;
+                    break;
+                }
+                demandRow = static_cast<long>(row);
+            }
+            if (demandRow < 0)
+            {
+                packedConsumerValid[c] = false;
+                continue;
+            }
+            float& demand(packedDemands[demandRow * consumerUids.size() + c]);
+            demand = std::max(demand, resourceAmounts[slot]);
+        }
+    }
+    packedMode = true;
+}
+
+// Every change of the packed matrices draws a new stamp (copies share the stamp as long as their matrices are equal)
+static std::atomic< std::uint64_t > lastPackedStamp(0);
+
+void Model::unpack()
+{
+    packedMode = false;
+    packedConsumerUids.clear();
+    packedProviderUids.clear();
+    packedConsumerColumns.clear();
+    packedProviderColumns.clear();
+    packedRows = 0;
+    packedProviderStride = 0;
+    packedCapacities.clear();
+    packedResiduals.clear();
+    packedDemands.clear();
+    packedSlots.clear();
+    packedConsumerValid.clear();
+    packedScores.clear();
+    packedScoredConsumers.clear();
+    packedScoredProviders.clear();
+    packedStamp = ++lastPackedStamp;
+}
+
+void Model::repack(const UniqueId& providerUid)
+{
+    if (!packedMode)
+        return;
+    packedStamp = ++lastPackedStamp;
+    const auto& it(packedProviderColumns.find(providerUid));
+    if (it == packedProviderColumns.end())
+        return;
+    if (!packedScoredProviders.empty())
+        packedScoredProviders[it->second] = 0;
+    for (std::size_t row = 0; row < packedRows; ++row)
+    {
+        const std::size_t idx(row * packedProviderStride + it->second);
+        if (packedSlots[idx] < 0)
+            continue;
+        packedResiduals[idx] = resourceAmounts[packedSlots[idx]] - resourceUsages[packedSlots[idx]];
+    }
+}
+
+bool Model::isPacked() const
+{
+    return packedMode;
+}
+
+const Hyperedges& Model::packedConsumers() const
+{
+    return packedConsumerUids;
+}
+
+const Hyperedges& Model::packedProviders() const
+{
+    return packedProviderUids;
+}
+
+std::size_t Model::packedStride() const
+{
+    return packedProviderStride;
+}
+
+const std::vector< float >& Model::capacities() const
+{
+    return packedCapacities;
+}
+
+const std::vector< float >& Model::residuals() const
+{
+    return packedResiduals;
+}
+
+const std::vector< float >& Model::demands() const
+{
+    return packedDemands;
+}
+
+bool Model::fits(const UniqueId& consumerUid, std::vector< float >& slack) const
+{
+    if (!packedMode)
+        return false;
+    const auto& it(packedConsumerColumns.find(consumerUid));
+    if ((it == packedConsumerColumns.end()) || !packedConsumerValid[it->second])
+        return false;
+    // Gather the (few) demands of the consumer
+    std::vector< std::size_t > rows;
+    std::vector< float > amounts;
+    for (std::size_t row = 0; row < packedRows; ++row)
+    {
+        const float demand(packedDemands[row * packedConsumerUids.size() + it->second]);
+        if (demand < 0.f)
+            continue;
+        rows.push_back(row);
+        amounts.push_back(demand);
+    }
+    slack.resize(packedProviderStride);
+    if (packedProviderStride)
+        fitsKernel(packedResiduals.data(), packedCapacities.data(), packedProviderStride, rows, amounts, slack.data());
+    slack.resize(packedProviderUids.size());
+    return true;
+}
+
+float Model::fits(const UniqueId& consumerUid, const UniqueId& providerUid) const
+{
+    const auto& it(packedProviderColumns.find(providerUid));
+    if (it != packedProviderColumns.end())
+    {
+        if (!packedScores.empty() && packedScoredProviders[it->second])
+        {
+            const auto& ct(packedConsumerColumns.find(consumerUid));
+            if ((ct != packedConsumerColumns.end()) && packedScoredConsumers[ct->second])
+                return counted(packedScores[ct->second * packedProviderUids.size() + it->second]);
+        }
+        // Evaluate the consumer against all providers once and answer the following queries from there
+        // NOTE: The slack is kept per thread, so several threads may query the same model
+        static thread_local std::uint64_t fitsStamp(0);
+        static thread_local UniqueId fitsConsumerUid;
+        static thread_local std::vector< float > fitsSlack;
+        if ((fitsStamp == packedStamp) && (fitsConsumerUid == consumerUid))
+            return counted(fitsSlack[it->second]);
+        if (fits(consumerUid, fitsSlack))
+        {
+            fitsStamp = packedStamp;
+            fitsConsumerUid = consumerUid;
+            return counted(fitsSlack[it->second]);
+        }
+        fitsStamp = 0;
+    }
+    return satisfies(Hyperedges{providerUid}, Hyperedges{consumerUid});
+}
+
+void Model::precompute(const unsigned int threads)
+{
+    if (!packedMode)
+        return;
+    const std::size_t nConsumers(packedConsumerUids.size());
+    const std::size_t nProviders(packedProviderUids.size());
+    packedScores.assign(nConsumers * nProviders, 0.f);
+    packedScoredConsumers.assign(nConsumers, 0);
+    packedScoredProviders.assign(nProviders, 1);
+    // Every worker evaluates the next unscored consumer against all providers (rows do not overlap, so no locking is needed)
+    std::atomic< std::size_t > next(0);
+    auto worker = [&] () {
+        std::vector< float > slack;
+        for (std::size_t c = next++; c < nConsumers; c = next++)
+        {
+            if (!fits(packedConsumerUids[c], slack))
+                continue;
+            std::copy(slack.begin(), slack.end(), packedScores.begin() + c * nProviders);
+            packedScoredConsumers[c] = 1;
+        }
+    };
+    std::vector< std::thread > pool;
+    for (unsigned int i = 1; i < threads; ++i)
+        pool.push_back(std::thread(worker));
+    worker();
+    for (std::thread& t : pool)
+        t.join();
+}
+
+Model Model::map (PartitionFunc partitionFuncLeft, PartitionFunc partitionFuncRight, MatchFunc matchFunc, MapFunc mapFunc, const unsigned int threads) const
+{
+    return map(partitionFuncLeft(*this), partitionFuncRight(*this), matchFunc, mapFunc, threads);
+}
+
+Model Model::map (const Hyperedges& leftUids, const Hyperedges& rightUids, MatchFunc matchFunc, MapFunc mapFunc, const unsigned int threads) const
+{
+    Model result(*this);
+    result.pack(leftUids, rightUids);
+    result.precompute(threads);
+    for (const UniqueId& leftUid : leftUids)
+    {
+        // Find the best match (greater means better)
+        float bestCosts(-std::numeric_limits<float>::infinity());
+        UniqueId bestRightUid;
+        for (const UniqueId& rightUid : rightUids)
+        {
+            const float costs(matchFunc(result, leftUid, rightUid));
+            if (costs > bestCosts)
+            {
+                bestCosts = costs;
+                bestRightUid = rightUid;
+            }
+        }
+        // Negative costs denote an invalid match
+        if (bestCosts < 0.f)
+            continue;
+        mapFunc(result, leftUid, bestRightUid);
+    }
+    result.unpack();
+    return result;
+}
+
 Hyperedges Model::partitionFuncLeft (const ResourceCost::Model& rcm)
 {
     const Hyperedges& consumerUids(rcm.consumers()); // get all consumer instances
@@ -243,14 +826,37 @@ Hyperedges Model::partitionFuncRight (const ResourceCost::Model& rcm)
 float Model::matchFunc (const ResourceCost::Model& rcm, const UniqueId& consumerUid, const UniqueId& providerUid)
 {
     // We can match all consumers to all providers
-    return rcm.satisfies(Hyperedges{providerUid}, Hyperedges{consumerUid});
+    return rcm.fits(consumerUid, providerUid);
+}
+
+bool Model::equivalentProviders (const ResourceCost::Model& rcm, const UniqueId& providerUidA, const UniqueId& providerUidB)
+{
+    // Describe every resource by its classes, amount and usage and compare the sorted descriptions
+    std::vector< std::string > descriptions[2];
+    const UniqueId providerUids[2] = {providerUidA, providerUidB};
+    for (std::size_t i = 0; i < 2; ++i)
+    {
+        const Hyperedges& availableResourceUids(rcm.resourcesOf(Hyperedges{providerUids[i]}));
+        for (const UniqueId& availableResourceUid : availableResourceUids)
+        {
+            Hyperedges classUids(rcm.instancesOf(Hyperedges{availableResourceUid}, "", FORWARD));
+            std::sort(classUids.begin(), classUids.end());
+            std::ostringstream description;
+            for (const UniqueId& classUid : classUids)
+                description << classUid << ";";
+            description << amountToLabel(rcm.amountOf(availableResourceUid)) << ";" << amountToLabel(rcm.usageOf(availableResourceUid));
+            descriptions[i].push_back(description.str());
+        }
+        std::sort(descriptions[i].begin(), descriptions[i].end());
+    }
+    return (descriptions[0] == descriptions[1]);
 }
 
 void Model::mapFunc (CommonConceptGraph& ccg, const UniqueId& consumerUid, const UniqueId& providerUid) 
 {
     ResourceCost::Model& rcm(static_cast< ResourceCost::Model& >(ccg));
     // Assign consumer to provider
-    rcm.factFrom(Hyperedges{consumerUid}, Hyperedges{providerUid}, ResourceCost::Model::MappedToUid);
+    rcm.mapTo(Hyperedges{consumerUid}, Hyperedges{providerUid}, ResourceCost::Model::MappedToUid);
 }
 
 }
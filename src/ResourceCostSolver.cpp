@@ -0,0 +1,1033 @@
+#include "ResourceCostSolver.hpp"
+#include "Diagnostics.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <deque>
+#include <limits>
+#include <random>
+#include <thread>
+#include <unordered_map>
+
+namespace ResourceCost {
+
+// Returns the sum of the fractions of the provided resources a consumer would consume
+static double consumptionOf(const Model& rcm, const UniqueId& consumerUid, const UniqueId& providerUid)
+{
+    double costs(0.0);
+    const Hyperedges& availableResourceUids(rcm.resourcesOf(Hyperedges{providerUid}));
+    for (const UniqueId& availableResourceUid : availableResourceUids)
+    {
+        const float available(rcm.amountOf(availableResourceUid));
+        if (available > 0.f)
+            costs += rcm.consumedOf(consumerUid, availableResourceUid) / available;
+    }
+    return costs;
+}
+
+// Returns the sum of the normalized residuals of the provided resources
+static double residualOf(const Model& rcm, const UniqueId& providerUid)
+{
+    double residual(0.0);
+    const Hyperedges& availableResourceUids(rcm.resourcesOf(Hyperedges{providerUid}));
+    for (const UniqueId& availableResourceUid : availableResourceUids)
+    {
+        const float available(rcm.amountOf(availableResourceUid));
+        if (available > 0.f)
+            residual += (available - rcm.usageOf(availableResourceUid)) / available;
+    }
+    return residual;
+}
+
+// Energy of a provided resource with utilization u (see AnnealingSolver)
+static double utilizationEnergy(const double u)
+{
+    return u + u * u;
+}
+
+// Greedy strategy (see Model::map) which subtracts the costs of the objective from the scores of valid matches
+static Model greedy(const Model& rcm, const Hyperedges& leftUids, const Hyperedges& rightUids, Model::MatchFunc matchFunc, Model::MapFunc mapFunc, const Objective& objective, const unsigned int threads=1)
+{
+    Model result(rcm);
+    result.pack(leftUids, rightUids);
+    result.precompute(threads);
+    for (const UniqueId& leftUid : leftUids)
+    {
+        // The neighbours do not change while we look for the best provider
+        const Objective::Placements& mappedNeighbours(objective.mappedNeighboursOf(result, leftUid));
+        // Find the best match (greater means better)
+        double bestScore(-std::numeric_limits<double>::infinity());
+        const UniqueId* bestRightUid(NULL);
+        for (const UniqueId& rightUid : rightUids)
+        {
+            const float costs(matchFunc(result, leftUid, rightUid));
+            // Negative costs denote an invalid match
+            if (costs < 0.f)
+                continue;
+            const double score(costs - objective.costsOf(leftUid, rightUid, mappedNeighbours));
+            if (score > bestScore)
+            {
+                bestScore = score;
+                bestRightUid = &rightUid;
+            }
+        }
+        if (!bestRightUid)
+            continue;
+        mapFunc(result, leftUid, *bestRightUid);
+    }
+    result.unpack();
+    return result;
+}
+
+namespace {
+
+struct FlowEdge
+{
+    std::size_t to;
+    long capacity;
+    double costs;
+    std::size_t reverse;
+};
+
+class FlowNetwork
+{
+    public:
+        FlowNetwork(const std::size_t nodes)
+        : edges(nodes)
+        {
+        }
+
+        void connect(const std::size_t from, const std::size_t to, const long capacity, const double costs)
+        {
+            edges[from].push_back(FlowEdge{to, capacity, costs, edges[to].size()});
+            edges[to].push_back(FlowEdge{from, 0, -costs, edges[from].size() - 1});
+        }
+
+        // Augments along cheapest paths from source to sink until the flow is maximal
+        // NOTE: The residual network has negative costs, so we use Bellman-Ford (queue based) to find the paths
+        void solve(const std::size_t source, const std::size_t sink)
+        {
+            const std::size_t n(edges.size());
+            while (true)
+            {
+                std::vector< double > distance(n, std::numeric_limits<double>::infinity());
+                std::vector< bool > queued(n, false);
+                std::vector< std::size_t > previousNode(n, n);
+                std::vector< std::size_t > previousEdge(n, 0);
+                std::deque< std::size_t > queue;
+                distance[source] = 0.0;
+                queue.push_back(source);
+                queued[source] = true;
+                while (!queue.empty())
+                {
+                    const std::size_t u(queue.front());
+                    queue.pop_front();
+                    queued[u] = false;
+                    for (std::size_t i = 0; i < edges[u].size(); ++i)
+                    {
+                        const FlowEdge& e(edges[u][i]);
+                        if (e.capacity <= 0)
+                            continue;
+                        // NOTE: The epsilon prevents cycling on rounding errors
+                        if (distance[u] + e.costs >= distance[e.to] - 1e-12)
+                            continue;
+                        distance[e.to] = distance[u] + e.costs;
+                        previousNode[e.to] = u;
+                        previousEdge[e.to] = i;
+                        if (!queued[e.to])
+                        {
+                            queue.push_back(e.to);
+                            queued[e.to] = true;
+                        }
+                    }
+                }
+                if (previousNode[sink] == n)
+                    break;
+                // Find bottleneck and augment
+                long flow(std::numeric_limits<long>::max());
+                for (std::size_t v = sink; v != source; v = previousNode[v])
+                    flow = std::min(flow, edges[previousNode[v]][previousEdge[v]].capacity);
+                for (std::size_t v = sink; v != source; v = previousNode[v])
+                {
+                    FlowEdge& e(edges[previousNode[v]][previousEdge[v]]);
+                    e.capacity -= flow;
+                    edges[v][e.reverse].capacity += flow;
+                }
+            }
+        }
+
+        std::vector< std::vector< FlowEdge > > edges;
+};
+
+class BranchAndBound
+{
+    public:
+        BranchAndBound(Model& model, const Hyperedges& left, const Hyperedges& right, Model::MatchFunc match, Model::MapFunc map, Model::EquivalenceFunc equivalent,
+                       const Objective& goal, const std::chrono::steady_clock::time_point& until)
+        : live(model), leftUids(left), rightUids(right), matchFunc(match), mapFunc(map), objective(goal), deadline(until),
+          nLeft(left.size()), nRight(right.size()),
+          costs(nLeft * nRight, 0.0), minCosts(nLeft, std::numeric_limits<double>::infinity()), candidates(nLeft),
+          leaders(nRight), hosted(nRight, 0), assignment(nLeft, -1), capacity(0.0), nodes(0), expired(false)
+        {
+            // Static feasibility and costs on the unmapped model
+            std::vector< std::vector< char > > feasible(nRight, std::vector< char >(nLeft, 0));
+            for (std::size_t c = 0; c < nLeft; ++c)
+            {
+                for (std::size_t p = 0; p < nRight; ++p)
+                {
+                    if (matchFunc(live, leftUids[c], rightUids[p]) < 0.f)
+                        continue;
+                    feasible[p][c] = 1;
+                    costs[c * nRight + p] = consumptionOf(live, leftUids[c], rightUids[p]);
+                    minCosts[c] = std::min(minCosts[c], costs[c * nRight + p]);
+                    candidates[c].push_back(p);
+                }
+                // Try cheap providers first
+                std::stable_sort(candidates[c].begin(), candidates[c].end(), [&] (const std::size_t a, const std::size_t b) {
+                    return costs[c * nRight + a] < costs[c * nRight + b];
+                });
+            }
+            // Most constrained consumers first
+            for (std::size_t c = 0; c < nLeft; ++c)
+                order.push_back(c);
+            std::stable_sort(order.begin(), order.end(), [&] (const std::size_t a, const std::size_t b) {
+                return candidates[a].size() < candidates[b].size();
+            });
+            // Group equivalent providers (they have to match the same consumers as well)
+            for (std::size_t p = 0; p < nRight; ++p)
+            {
+                leaders[p] = p;
+                for (std::size_t q = 0; q < p; ++q)
+                {
+                    if ((leaders[q] != q) || (feasible[q] != feasible[p]) || !equivalent(live, rightUids[q], rightUids[p]))
+                        continue;
+                    leaders[p] = q;
+                    break;
+                }
+                capacity += residualOf(live, rightUids[p]);
+            }
+        }
+
+        // Sets the incumbent (and the costs of its objective)
+        void incumbent(const std::vector< long >& solution, const double paired)
+        {
+            bestAssignment = solution;
+            bestUnmapped = 0;
+            bestCosts = paired;
+            for (std::size_t c = 0; c < nLeft; ++c)
+            {
+                if (solution[c] < 0)
+                    ++bestUnmapped;
+                else
+                    bestCosts += costs[c * nRight + solution[c]];
+            }
+        }
+
+        // NOTE: The costs of the objective (paired) do not consume any capacity, so we keep them apart
+        void search(const std::size_t depth, const std::size_t unmapped, const double consumed, const double paired)
+        {
+            if (expired)
+                return;
+            ++nodes;
+            if (std::chrono::steady_clock::now() >= deadline)
+            {
+                expired = true;
+                return;
+            }
+            if (depth == nLeft)
+            {
+                if ((unmapped < bestUnmapped) || ((unmapped == bestUnmapped) && (consumed + paired < bestCosts - 1e-9)))
+                {
+                    bestAssignment = assignment;
+                    bestUnmapped = unmapped;
+                    bestCosts = consumed + paired;
+                }
+                return;
+            }
+
+            // Bound: the cheapest costs of the remaining consumers have to fit into the remaining capacity
+            std::vector< double > remainingCosts;
+            std::size_t lowerUnmapped(unmapped);
+            for (std::size_t i = depth; i < nLeft; ++i)
+            {
+                if (candidates[order[i]].empty())
+                    ++lowerUnmapped;
+                else
+                    remainingCosts.push_back(minCosts[order[i]]);
+            }
+            std::sort(remainingCosts.begin(), remainingCosts.end());
+            double sum(0.0);
+            std::size_t mappable(0);
+            while ((mappable < remainingCosts.size()) && (sum + remainingCosts[mappable] <= capacity - consumed + 1e-9))
+                sum += remainingCosts[mappable++];
+            lowerUnmapped += remainingCosts.size() - mappable;
+            if (lowerUnmapped > bestUnmapped)
+                return;
+            if (lowerUnmapped == bestUnmapped)
+            {
+                // At least (remaining - allowed unmapped) consumers have to be mapped
+                const std::size_t mapped(nLeft - depth - (bestUnmapped - unmapped));
+                double lowerCosts(consumed + paired);
+                for (std::size_t i = 0; i < mapped; ++i)
+                    lowerCosts += remainingCosts[i];
+                if (lowerCosts >= bestCosts - 1e-9)
+                    return;
+            }
+
+            // Branch
+            const std::size_t c(order[depth]);
+            for (const std::size_t p : candidates[c])
+            {
+                // Symmetry breaking: Use only the first of several unused, equivalent providers
+                if (!hosted[p] && unusedEquivalentBefore(p))
+                    continue;
+                if (matchFunc(live, leftUids[c], rightUids[p]) < 0.f)
+                    continue;
+                const double pairedCosts(objective.costsOf(live, leftUids[c], rightUids[p]));
+                mapFunc(live, leftUids[c], rightUids[p]);
+                ++hosted[p];
+                assignment[c] = p;
+                search(depth + 1, unmapped, consumed + costs[c * nRight + p], paired + pairedCosts);
+                live.unmap(Hyperedges{leftUids[c]});
+                --hosted[p];
+                assignment[c] = -1;
+                if (expired)
+                    return;
+            }
+            // ... or leave the consumer unmapped
+            search(depth + 1, unmapped + 1, consumed, paired);
+        }
+
+        bool unusedEquivalentBefore(const std::size_t p) const
+        {
+            for (std::size_t q = leaders[p]; q < p; ++q)
+            {
+                if ((leaders[q] == leaders[p]) && !hosted[q])
+                    return true;
+            }
+            return false;
+        }
+
+        Model& live;
+        const Hyperedges& leftUids;
+        const Hyperedges& rightUids;
+        Model::MatchFunc matchFunc;
+        Model::MapFunc mapFunc;
+        const Objective& objective;
+        const std::chrono::steady_clock::time_point deadline;
+        const std::size_t nLeft;
+        const std::size_t nRight;
+        std::vector< double > costs;
+        std::vector< double > minCosts;
+        std::vector< std::vector< std::size_t > > candidates;
+        std::vector< std::size_t > order;
+        std::vector< std::size_t > leaders;
+        std::vector< std::size_t > hosted;
+        std::vector< long > assignment;
+        std::vector< long > bestAssignment;
+        std::size_t bestUnmapped;
+        double bestCosts;
+        double capacity;
+        std::size_t nodes;
+        bool expired;
+};
+
+}
+
+Objective::~Objective()
+{
+}
+
+Hyperedges Objective::neighboursOf(const UniqueId& consumerUid) const
+{
+    return Hyperedges();
+}
+
+double Objective::costsBetween(const UniqueId& consumerUidA, const UniqueId& providerUidA, const UniqueId& consumerUidB, const UniqueId& providerUidB) const
+{
+    return 0.0;
+}
+
+Objective::Placements Objective::mappedNeighboursOf(const Model& rcm, const UniqueId& consumerUid) const
+{
+    Placements result;
+    for (const UniqueId& neighbourUid : neighboursOf(consumerUid))
+    {
+        for (const UniqueId& providerUid : rcm.providersOf(Hyperedges{neighbourUid}))
+            result.push_back(std::make_pair(neighbourUid, providerUid));
+    }
+    return result;
+}
+
+double Objective::costsOf(const UniqueId& consumerUid, const UniqueId& providerUid, const Placements& mappedNeighbours) const
+{
+    double costs(0.0);
+    for (const Placements::value_type& placement : mappedNeighbours)
+        costs += costsBetween(consumerUid, providerUid, placement.first, placement.second);
+    return costs;
+}
+
+double Objective::costsOf(const Model& rcm, const UniqueId& consumerUid, const UniqueId& providerUid) const
+{
+    return costsOf(consumerUid, providerUid, mappedNeighboursOf(rcm, consumerUid));
+}
+
+double Objective::costsOf(const Model& rcm, const Hyperedges& consumerUids) const
+{
+    Hyperedges sortedUids(consumerUids);
+    std::sort(sortedUids.begin(), sortedUids.end());
+    double costs(0.0);
+    for (const UniqueId& consumerUid : consumerUids)
+    {
+        const Placements& mappedNeighbours(mappedNeighboursOf(rcm, consumerUid));
+        if (mappedNeighbours.empty())
+            continue;
+        for (const UniqueId& providerUid : rcm.providersOf(Hyperedges{consumerUid}))
+        {
+            for (const Placements::value_type& placement : mappedNeighbours)
+            {
+                // Pairs of the given consumers are counted by the smaller one
+                if ((placement.first < consumerUid) && std::binary_search(sortedUids.begin(), sortedUids.end(), placement.first))
+                    continue;
+                costs += costsBetween(consumerUid, providerUid, placement.first, placement.second);
+            }
+        }
+    }
+    return costs;
+}
+
+Solver::~Solver()
+{
+}
+
+std::string Solver::name() const
+{
+    return "greedy";
+}
+
+Model Solver::solve(const Model& rcm,
+                    Model::PartitionFunc partitionFuncLeft,
+                    Model::PartitionFunc partitionFuncRight,
+                    Model::MatchFunc matchFunc,
+                    Model::MapFunc mapFunc,
+                    const unsigned int threads,
+                    const Objective& objective) const
+{
+    return greedy(rcm, partitionFuncLeft(rcm), partitionFuncRight(rcm), matchFunc, mapFunc, objective, threads);
+}
+
+AssignmentSolver::AssignmentSolver(const enum Mode& mode, const std::size_t rounds)
+: solverMode(mode), maxRounds(rounds)
+{
+}
+
+std::string AssignmentSolver::name() const
+{
+    return (solverMode == UNIT_CAPACITY) ? "hungarian" : "mincostflow";
+}
+
+Model AssignmentSolver::solve(const Model& rcm,
+                              Model::PartitionFunc partitionFuncLeft,
+                              Model::PartitionFunc partitionFuncRight,
+                              Model::MatchFunc matchFunc,
+                              Model::MapFunc mapFunc,
+                              const unsigned int threads,
+                              const Objective& objective) const
+{
+    const Hyperedges& leftUids(partitionFuncLeft(rcm));
+    const Hyperedges& rightUids(partitionFuncRight(rcm));
+    const std::size_t nLeft(leftUids.size());
+    const std::size_t nRight(rightUids.size());
+
+    // Determine how many consumers each provider can host
+    std::vector< long > slots(nRight, (solverMode == UNIT_CAPACITY) ? 1 : nLeft);
+    if (solverMode == UNIFORM_DEMANDS)
+    {
+        for (std::size_t p = 0; p < nRight; ++p)
+        {
+            const Hyperedges& availableResourceUids(rcm.resourcesOf(Hyperedges{rightUids[p]}));
+            for (const UniqueId& availableResourceUid : availableResourceUids)
+            {
+                float demand(-1.f);
+                for (const UniqueId& leftUid : leftUids)
+                {
+                    const float consumed(rcm.consumedOf(leftUid, availableResourceUid));
+                    if (demand < 0.f)
+                        demand = consumed;
+                    if (consumed == demand)
+                        continue;
+                    DIAGNOSE(Diagnostics::WARNING, "ASSIGNMENT: Demands are not uniform, falling back to " << Solver::name());
+                    return Solver::solve(rcm, partitionFuncLeft, partitionFuncRight, matchFunc, mapFunc, threads, objective);
+                }
+                if (demand <= 0.f)
+                    continue;
+                // Count how often the demand can be served (the same way satisfies() does)
+                const float available(rcm.amountOf(availableResourceUid));
+                float used(rcm.usageOf(availableResourceUid));
+                long k(0);
+                while ((k < slots[p]) && ((available - used - demand) / available >= 0.f))
+                {
+                    used += demand;
+                    ++k;
+                }
+                slots[p] = k;
+            }
+        }
+    }
+
+    // The edges of the flow network (the match function is evaluated on the unmapped model) and their costs towards neighbours outside of the assignment
+    // NOTE: These neighbours keep their providers, so the costs towards them are linear
+    Model packed(rcm);
+    packed.pack(leftUids, rightUids);
+    packed.precompute(threads);
+    std::unordered_map< UniqueId, std::size_t > leftIndices;
+    std::unordered_map< UniqueId, std::size_t > rightIndices;
+    for (std::size_t c = 0; c < nLeft; ++c)
+        leftIndices[leftUids[c]] = c;
+    for (std::size_t p = 0; p < nRight; ++p)
+        rightIndices[rightUids[p]] = p;
+    std::vector< std::vector< std::pair< std::size_t, double > > > candidates(nLeft);
+    std::vector< std::vector< std::size_t > > coupledNeighbours(nLeft);
+    bool coupled(false);
+    for (std::size_t c = 0; c < nLeft; ++c)
+    {
+        const Objective::Placements& mappedNeighbours(objective.mappedNeighboursOf(packed, leftUids[c]));
+        for (std::size_t p = 0; p < nRight; ++p)
+        {
+            if (matchFunc(packed, leftUids[c], rightUids[p]) < 0.f)
+                continue;
+            candidates[c].push_back(std::make_pair(p, consumptionOf(packed, leftUids[c], rightUids[p]) + objective.costsOf(leftUids[c], rightUids[p], mappedNeighbours)));
+        }
+        for (const UniqueId& neighbourUid : objective.neighboursOf(leftUids[c]))
+        {
+            const auto& it(leftIndices.find(neighbourUid));
+            if (it == leftIndices.end())
+                continue;
+            coupledNeighbours[c].push_back(it->second);
+            coupled = coupled || ((nRight > 1) && (objective.costsBetween(leftUids[c], rightUids[0], neighbourUid, rightUids[1]) > 0.0));
+        }
+    }
+
+    // The costs between two consumers which are both assigned here are not linear.
+    // So the flow is solved again with the costs towards the providers of these neighbours in the previous round.
+    // In every round after the first, every other consumer keeps its provider, so pairs cannot just swap their providers.
+    const std::size_t rounds(coupled ? std::max< std::size_t >(1, maxRounds) : 1);
+    std::vector< long > previous(nLeft, -1);
+    Model best;
+    std::size_t bestRound(0);
+    std::size_t bestUnmapped(0);
+    double bestScore(0.0);
+    std::size_t stable(0);
+    std::size_t round(0);
+    for (; (round < rounds) && (stable < 2); ++round)
+    {
+        const std::size_t source(nLeft + nRight);
+        const std::size_t sink(nLeft + nRight + 1);
+        FlowNetwork network(nLeft + nRight + 2);
+        for (std::size_t c = 0; c < nLeft; ++c)
+        {
+            network.connect(source, c, 1, 0.0);
+            // NOTE: The previous provider may have been found by the greedy pass only, then the consumer is free
+            bool pinned((round > 0) && (c % 2 == round % 2) && (previous[c] >= 0));
+            pinned = pinned && std::any_of(candidates[c].begin(), candidates[c].end(), [&] (const std::pair< std::size_t, double >& candidate) { return static_cast< long >(candidate.first) == previous[c]; });
+            for (const std::pair< std::size_t, double >& candidate : candidates[c])
+            {
+                if (pinned && (static_cast< long >(candidate.first) != previous[c]))
+                    continue;
+                double costs(candidate.second);
+                for (const std::size_t n : coupledNeighbours[c])
+                {
+                    if (previous[n] >= 0)
+                        costs += objective.costsBetween(leftUids[c], rightUids[candidate.first], leftUids[n], rightUids[previous[n]]);
+                }
+                network.connect(c, nLeft + candidate.first, 1, costs);
+            }
+        }
+        for (std::size_t p = 0; p < nRight; ++p)
+        {
+            if (slots[p] > 0)
+                network.connect(nLeft + p, sink, slots[p], 0.0);
+        }
+        network.solve(source, sink);
+
+        // Establish the assignments
+        Model result(packed);
+        Hyperedges unassignedUids;
+        for (std::size_t c = 0; c < nLeft; ++c)
+        {
+            bool assigned = false;
+            for (const FlowEdge& e : network.edges[c])
+            {
+                if ((e.to < nLeft) || (e.to >= nLeft + nRight) || (e.capacity > 0))
+                    continue;
+                const UniqueId& rightUid(rightUids[e.to - nLeft]);
+                if (matchFunc(result, leftUids[c], rightUid) >= 0.f)
+                {
+                    mapFunc(result, leftUids[c], rightUid);
+                    assigned = true;
+                }
+                break;
+            }
+            if (!assigned)
+                unassignedUids.push_back(leftUids[c]);
+        }
+        result.unpack();
+
+        // Map the remaining consumers greedily
+        if (!unassignedUids.empty())
+        {
+            DIAGNOSE(Diagnostics::INFO, "ASSIGNMENT: " << unassignedUids.size() << " consumers left to " << Solver::name());
+            result = greedy(result, unassignedUids, rightUids, matchFunc, mapFunc, objective, threads);
+        }
+
+        // Keep the best (and in case of ties the first) round (see MultiStartSolver)
+        std::size_t unmapped(0);
+        std::vector< long > current(nLeft, -1);
+        for (std::size_t c = 0; c < nLeft; ++c)
+        {
+            const Hyperedges& providerUids(intersect(result.providersOf(Hyperedges{leftUids[c]}), rightUids));
+            if (providerUids.empty())
+                ++unmapped;
+            else
+                current[c] = rightIndices[providerUids[0]];
+        }
+        double score(-objective.costsOf(result, leftUids));
+        for (const UniqueId& rightUid : rightUids)
+            score += residualOf(result, rightUid);
+        if ((round == 0) || (unmapped < bestUnmapped) || ((unmapped == bestUnmapped) && (score > bestScore + 1e-9)))
+        {
+            best = result;
+            bestRound = round;
+            bestUnmapped = unmapped;
+            bestScore = score;
+        }
+        stable = (current == previous) ? stable + 1 : 0;
+        previous.swap(current);
+    }
+    if (coupled)
+        DIAGNOSE(Diagnostics::INFO, "ASSIGNMENT: " << round << " rounds, best: " << bestRound << ", unmapped: " << bestUnmapped << ", score: " << bestScore);
+    return best;
+}
+
+BranchAndBoundSolver::BranchAndBoundSolver(const double budget, Model::EquivalenceFunc equivalenceFunc)
+: budgetInSeconds(budget), equivalent(equivalenceFunc)
+{
+}
+
+std::string BranchAndBoundSolver::name() const
+{
+    return "branchandbound";
+}
+
+Model BranchAndBoundSolver::solve(const Model& rcm,
+                                  Model::PartitionFunc partitionFuncLeft,
+                                  Model::PartitionFunc partitionFuncRight,
+                                  Model::MatchFunc matchFunc,
+                                  Model::MapFunc mapFunc,
+                                  const unsigned int threads,
+                                  const Objective& objective) const
+{
+    const std::chrono::steady_clock::time_point deadline(std::chrono::steady_clock::now() + std::chrono::duration_cast< std::chrono::steady_clock::duration >(std::chrono::duration< double >(budgetInSeconds)));
+    const Hyperedges& leftUids(partitionFuncLeft(rcm));
+    const Hyperedges& rightUids(partitionFuncRight(rcm));
+
+    // The greedy solution is our first incumbent
+    const Model greedy(Solver::solve(rcm, partitionFuncLeft, partitionFuncRight, matchFunc, mapFunc, threads, objective));
+    std::vector< long > solution(leftUids.size(), -1);
+    for (std::size_t c = 0; c < leftUids.size(); ++c)
+    {
+        const Hyperedges& providerUids(greedy.providersOf(Hyperedges{leftUids[c]}));
+        for (std::size_t p = 0; p < rightUids.size(); ++p)
+        {
+            if (std::find(providerUids.begin(), providerUids.end(), rightUids[p]) != providerUids.end())
+                solution[c] = p;
+        }
+    }
+
+    // Search
+    Model live(rcm);
+    live.pack(leftUids, rightUids);
+    live.precompute(threads);
+    BranchAndBound bnb(live, leftUids, rightUids, matchFunc, mapFunc, equivalent, objective, deadline);
+    bnb.incumbent(solution, objective.costsOf(greedy, leftUids));
+    const std::vector< long > greedySolution(bnb.bestAssignment);
+    bnb.search(0, 0, 0.0, 0.0);
+    DIAGNOSE(Diagnostics::INFO, "BRANCH AND BOUND: " << bnb.nodes << " nodes, " << (bnb.expired ? "budget exhausted" : "optimal") << ", unmapped: " << bnb.bestUnmapped << ", costs: " << bnb.bestCosts);
+    if (bnb.bestAssignment == greedySolution)
+        return greedy;
+
+    // Establish the best solution
+    Model result(rcm);
+    for (const std::size_t c : bnb.order)
+    {
+        if (bnb.bestAssignment[c] < 0)
+            continue;
+        mapFunc(result, leftUids[c], rightUids[bnb.bestAssignment[c]]);
+    }
+    return result;
+}
+
+AnnealingSolver::AnnealingSolver(const unsigned long seed, const std::size_t iterations, const double budget)
+: randomSeed(seed), maxIterations(iterations), budgetInSeconds(budget)
+{
+}
+
+std::string AnnealingSolver::name() const
+{
+    return "annealing";
+}
+
+Model AnnealingSolver::solve(const Model& rcm,
+                             Model::PartitionFunc partitionFuncLeft,
+                             Model::PartitionFunc partitionFuncRight,
+                             Model::MatchFunc matchFunc,
+                             Model::MapFunc mapFunc,
+                             const unsigned int threads,
+                             const Objective& objective) const
+{
+    // NOTE: The partitions may depend on the mapping (e.g. only unmapped consumers), so we evaluate them before
+    const Hyperedges& leftUids(partitionFuncLeft(rcm));
+    const Hyperedges& rightUids(partitionFuncRight(rcm));
+    Model result(Solver::solve(rcm, partitionFuncLeft, partitionFuncRight, matchFunc, mapFunc, threads, objective));
+    improve(result, leftUids, rightUids, matchFunc, mapFunc, objective);
+    return result;
+}
+
+double AnnealingSolver::improve(Model& rcm,
+                                Model::PartitionFunc partitionFuncLeft,
+                                Model::PartitionFunc partitionFuncRight,
+                                Model::MatchFunc matchFunc,
+                                Model::MapFunc mapFunc,
+                                const Objective& objective) const
+{
+    return improve(rcm, partitionFuncLeft(rcm), partitionFuncRight(rcm), matchFunc, mapFunc, objective);
+}
+
+double AnnealingSolver::improve(Model& rcm,
+                                const Hyperedges& leftUids,
+                                const Hyperedges& rightUids,
+                                Model::MatchFunc matchFunc,
+                                Model::MapFunc mapFunc,
+                                const Objective& objective) const
+{
+    const std::chrono::steady_clock::time_point deadline(std::chrono::steady_clock::now() + std::chrono::duration_cast< std::chrono::steady_clock::duration >(std::chrono::duration< double >(budgetInSeconds)));
+    const std::size_t nLeft(leftUids.size());
+    const std::size_t nRight(rightUids.size());
+    if (!nLeft || !nRight)
+        return 0.0;
+
+    // Get the current assignment
+    std::vector< long > assignment(nLeft, -1);
+    for (std::size_t c = 0; c < nLeft; ++c)
+    {
+        const Hyperedges& providerUids(rcm.providersOf(Hyperedges{leftUids[c]}));
+        for (std::size_t p = 0; p < nRight; ++p)
+        {
+            if (std::find(providerUids.begin(), providerUids.end(), rightUids[p]) != providerUids.end())
+                assignment[c] = p;
+        }
+    }
+
+    // Collect the provided resources and what every consumer would consume of them
+    std::vector< std::vector< double > > amounts(nRight);
+    std::vector< std::vector< double > > usages(nRight);
+    std::vector< std::vector< std::vector< double > > > consumed(nLeft, std::vector< std::vector< double > >(nRight));
+    std::size_t nResources(0);
+    for (std::size_t p = 0; p < nRight; ++p)
+    {
+        const Hyperedges& availableResourceUids(rcm.resourcesOf(Hyperedges{rightUids[p]}));
+        for (const UniqueId& availableResourceUid : availableResourceUids)
+        {
+            amounts[p].push_back(rcm.amountOf(availableResourceUid));
+            usages[p].push_back(rcm.usageOf(availableResourceUid));
+            for (std::size_t c = 0; c < nLeft; ++c)
+                consumed[c][p].push_back(rcm.consumedOf(leftUids[c], availableResourceUid));
+            ++nResources;
+        }
+    }
+    // An unmapped consumer has to be worse than any utilization
+    const double penalty(2.0 * nResources + 1.0);
+
+    // Collect the neighbours of every consumer: those of the partition (by index) and the others (which stay where they are)
+    std::unordered_map< UniqueId, std::size_t > consumerIndices;
+    for (std::size_t c = 0; c < nLeft; ++c)
+        consumerIndices[leftUids[c]] = c;
+    std::vector< std::vector< std::size_t > > partners(nLeft);
+    std::vector< Objective::Placements > fixedPartners(nLeft);
+    for (std::size_t c = 0; c < nLeft; ++c)
+    {
+        for (const UniqueId& neighbourUid : objective.neighboursOf(leftUids[c]))
+        {
+            std::unordered_map< UniqueId, std::size_t >::const_iterator it(consumerIndices.find(neighbourUid));
+            if (it != consumerIndices.end())
+            {
+                partners[c].push_back(it->second);
+                continue;
+            }
+            for (const UniqueId& providerUid : rcm.providersOf(Hyperedges{neighbourUid}))
+                fixedPartners[c].push_back(std::make_pair(neighbourUid, providerUid));
+        }
+    }
+
+    // Returns the change of energy at provider p if consumer a leaves and consumer b arrives (use nLeft for nobody)
+    auto deltaAt = [&] (const std::size_t p, const std::size_t a, const std::size_t b) {
+        double delta(0.0);
+        for (std::size_t r = 0; r < amounts[p].size(); ++r)
+        {
+            if (amounts[p][r] <= 0.0)
+                continue;
+            double usage(usages[p][r]);
+            if (a < nLeft)
+                usage -= consumed[a][p][r];
+            if (b < nLeft)
+                usage += consumed[b][p][r];
+            delta += utilizationEnergy(usage / amounts[p][r]) - utilizationEnergy(usages[p][r] / amounts[p][r]);
+        }
+        return delta;
+    };
+    // Returns the costs of the objective between consumer c at provider p and its mapped neighbours (except consumer skip)
+    auto pairedAt = [&] (const std::size_t c, const long p, const std::size_t skip) {
+        double costs(0.0);
+        if (p < 0)
+            return costs;
+        for (const std::size_t d : partners[c])
+        {
+            if ((d != skip) && (assignment[d] >= 0))
+                costs += objective.costsBetween(leftUids[c], rightUids[p], leftUids[d], rightUids[assignment[d]]);
+        }
+        return costs + objective.costsOf(leftUids[c], rightUids[p], fixedPartners[c]);
+    };
+    auto update = [&] (const std::size_t p, const std::size_t a, const std::size_t b) {
+        for (std::size_t r = 0; r < amounts[p].size(); ++r)
+        {
+            if (a < nLeft)
+                usages[p][r] -= consumed[a][p][r];
+            if (b < nLeft)
+                usages[p][r] += consumed[b][p][r];
+        }
+    };
+
+    double energy(0.0);
+    for (std::size_t p = 0; p < nRight; ++p)
+    {
+        for (std::size_t r = 0; r < amounts[p].size(); ++r)
+        {
+            if (amounts[p][r] > 0.0)
+                energy += utilizationEnergy(usages[p][r] / amounts[p][r]);
+        }
+    }
+    for (std::size_t c = 0; c < nLeft; ++c)
+    {
+        if (assignment[c] < 0)
+            energy += penalty;
+    }
+    energy += objective.costsOf(rcm, leftUids);
+    const double initialEnergy(energy);
+    double bestEnergy(energy);
+    std::vector< long > bestAssignment(assignment);
+
+    // Anneal
+    std::mt19937 rng(randomSeed);
+    std::uniform_int_distribution< std::size_t > anyConsumer(0, nLeft - 1);
+    std::uniform_int_distribution< std::size_t > anyProvider(0, nRight - 1);
+    std::uniform_real_distribution< double > uniform(0.0, 1.0);
+    const double startTemperature(1.0);
+    const double endTemperature(1e-3);
+    std::size_t iteration(0);
+    std::size_t accepted(0);
+    for (; iteration < maxIterations; ++iteration)
+    {
+        if (std::chrono::steady_clock::now() >= deadline)
+            break;
+        const double temperature(startTemperature * std::pow(endTemperature / startTemperature, static_cast<double>(iteration) / maxIterations));
+        const std::size_t c(anyConsumer(rng));
+        const long p(assignment[c]);
+        const bool swap((p >= 0) && (uniform(rng) < 0.5));
+        if (!swap)
+        {
+            // Move c from p to q
+            const long q(anyProvider(rng));
+            if (q == p)
+                continue;
+            const double delta(((p >= 0) ? deltaAt(p, c, nLeft) : -penalty) + deltaAt(q, nLeft, c) + pairedAt(c, q, nLeft) - pairedAt(c, p, nLeft));
+            if ((delta > 0.0) && (uniform(rng) >= std::exp(-delta / temperature)))
+                continue;
+            if (p >= 0)
+                rcm.unmap(Hyperedges{leftUids[c]});
+            if (matchFunc(rcm, leftUids[c], rightUids[q]) < 0.f)
+            {
+                if (p >= 0)
+                    mapFunc(rcm, leftUids[c], rightUids[p]);
+                continue;
+            }
+            mapFunc(rcm, leftUids[c], rightUids[q]);
+            if (p >= 0)
+                update(p, c, nLeft);
+            update(q, nLeft, c);
+            assignment[c] = q;
+            energy += delta;
+        } else {
+            // Swap the providers of c and d
+            const std::size_t d(anyConsumer(rng));
+            const long q(assignment[d]);
+            if ((q < 0) || (q == p))
+                continue;
+            double delta(deltaAt(p, c, d) + deltaAt(q, d, c) + pairedAt(c, q, d) - pairedAt(c, p, d) + pairedAt(d, p, c) - pairedAt(d, q, c));
+            if (std::find(partners[c].begin(), partners[c].end(), d) != partners[c].end())
+                delta += objective.costsBetween(leftUids[c], rightUids[q], leftUids[d], rightUids[p]) - objective.costsBetween(leftUids[c], rightUids[p], leftUids[d], rightUids[q]);
+            if ((delta > 0.0) && (uniform(rng) >= std::exp(-delta / temperature)))
+                continue;
+            rcm.unmap(Hyperedges{leftUids[c], leftUids[d]});
+            bool valid(matchFunc(rcm, leftUids[c], rightUids[q]) >= 0.f);
+            if (valid)
+            {
+                mapFunc(rcm, leftUids[c], rightUids[q]);
+                valid = (matchFunc(rcm, leftUids[d], rightUids[p]) >= 0.f);
+                if (!valid)
+                    rcm.unmap(Hyperedges{leftUids[c]});
+            }
+            if (!valid)
+            {
+                mapFunc(rcm, leftUids[c], rightUids[p]);
+                mapFunc(rcm, leftUids[d], rightUids[q]);
+                continue;
+            }
+            mapFunc(rcm, leftUids[d], rightUids[p]);
+            update(p, c, d);
+            update(q, d, c);
+            assignment[c] = q;
+            assignment[d] = p;
+            energy += delta;
+        }
+        ++accepted;
+        if (energy < bestEnergy - 1e-12)
+        {
+            bestEnergy = energy;
+            bestAssignment = assignment;
+        }
+    }
+
+    // Establish the best solution
+    if (assignment != bestAssignment)
+    {
+        for (std::size_t c = 0; c < nLeft; ++c)
+        {
+            if ((assignment[c] != bestAssignment[c]) && (assignment[c] >= 0))
+                rcm.unmap(Hyperedges{leftUids[c]});
+        }
+        for (std::size_t c = 0; c < nLeft; ++c)
+        {
+            if ((assignment[c] != bestAssignment[c]) && (bestAssignment[c] >= 0))
+                mapFunc(rcm, leftUids[c], rightUids[bestAssignment[c]]);
+        }
+    }
+    DIAGNOSE(Diagnostics::INFO, "ANNEALING: " << iteration << " iterations, " << accepted << " steps accepted, energy: " << initialEnergy << " -> " << bestEnergy);
+    return initialEnergy - bestEnergy;
+}
+
+MultiStartSolver::MultiStartSolver(const std::size_t restarts, const unsigned long seed)
+: numRestarts(std::max< std::size_t >(restarts, 1)), randomSeed(seed)
+{
+}
+
+std::string MultiStartSolver::name() const
+{
+    return "multistart";
+}
+
+Model MultiStartSolver::solve(const Model& rcm,
+                              Model::PartitionFunc partitionFuncLeft,
+                              Model::PartitionFunc partitionFuncRight,
+                              Model::MatchFunc matchFunc,
+                              Model::MapFunc mapFunc,
+                              const unsigned int threads,
+                              const Objective& objective) const
+{
+    const Hyperedges& leftUids(partitionFuncLeft(rcm));
+    const Hyperedges& rightUids(partitionFuncRight(rcm));
+
+    // Prepare the orders of all passes (sequentially, so they do not depend on the threads)
+    std::vector< Hyperedges > leftOrders(numRestarts, leftUids);
+    std::vector< Hyperedges > rightOrders(numRestarts, rightUids);
+    if (numRestarts > 1)
+    {
+        std::vector< double > demands(leftUids.size(), 0.0);
+        for (std::size_t c = 0; c < leftUids.size(); ++c)
+        {
+            for (const UniqueId& rightUid : rightUids)
+                demands[c] += consumptionOf(rcm, leftUids[c], rightUid);
+        }
+        std::vector< std::size_t > order(leftUids.size());
+        for (std::size_t c = 0; c < order.size(); ++c)
+            order[c] = c;
+        std::stable_sort(order.begin(), order.end(), [&] (const std::size_t a, const std::size_t b) { return demands[a] > demands[b]; });
+        for (std::size_t i = 0; i < order.size(); ++i)
+            leftOrders[1][i] = leftUids[order[i]];
+    }
+    if (numRestarts > 2)
+    {
+        std::vector< std::size_t > matches(leftUids.size(), 0);
+        for (std::size_t c = 0; c < leftUids.size(); ++c)
+        {
+            for (const UniqueId& rightUid : rightUids)
+            {
+                if (matchFunc(rcm, leftUids[c], rightUid) >= 0.f)
+                    ++matches[c];
+            }
+        }
+        std::vector< std::size_t > order(leftUids.size());
+        for (std::size_t c = 0; c < order.size(); ++c)
+            order[c] = c;
+        std::stable_sort(order.begin(), order.end(), [&] (const std::size_t a, const std::size_t b) { return matches[a] < matches[b]; });
+        for (std::size_t i = 0; i < order.size(); ++i)
+            leftOrders[2][i] = leftUids[order[i]];
+    }
+    for (std::size_t k = 3; k < numRestarts; ++k)
+    {
+        std::mt19937 rng(randomSeed + k);
+        std::shuffle(leftOrders[k].begin(), leftOrders[k].end(), rng);
+        std::shuffle(rightOrders[k].begin(), rightOrders[k].end(), rng);
+    }
+
+    // Run the passes in parallel (every pass works on its own copy of the model)
+    std::vector< Model > results(numRestarts);
+    std::vector< std::size_t > unmapped(numRestarts, 0);
+    std::vector< double > residuals(numRestarts, 0.0);
+    std::vector< double > pairedCosts(numRestarts, 0.0);
+    std::atomic< std::size_t > next(0);
+    const RunContext* context(RunContext::current());
+    auto worker = [&] () {
+        const RunContext::Scope scope(context);
+        for (std::size_t k = next++; k < numRestarts; k = next++)
+        {
+            results[k] = greedy(rcm, leftOrders[k], rightOrders[k], matchFunc, mapFunc, objective);
+            for (const UniqueId& leftUid : leftUids)
+            {
+                if (intersect(results[k].providersOf(Hyperedges{leftUid}), rightUids).empty())
+                    ++unmapped[k];
+            }
+            for (const UniqueId& rightUid : rightUids)
+                residuals[k] += residualOf(results[k], rightUid);
+            pairedCosts[k] = objective.costsOf(results[k], leftUids);
+        }
+    };
+    std::vector< std::thread > pool;
+    for (unsigned int i = 1; (i < threads) && (i < numRestarts); ++i)
+        pool.push_back(std::thread(worker));
+    worker();
+    for (std::thread& t : pool)
+        t.join();
+
+    // Keep the best (and in case of ties the first) pass
+    std::size_t best(0);
+    for (std::size_t k = 1; k < numRestarts; ++k)
+    {
+        if ((unmapped[k] < unmapped[best]) || ((unmapped[k] == unmapped[best]) && (residuals[k] - pairedCosts[k] > residuals[best] - pairedCosts[best] + 1e-9)))
+            best = k;
+    }
+    DIAGNOSE(Diagnostics::INFO, "MULTI START: " << numRestarts << " passes, best: " << best << ", unmapped: " << unmapped[best] << ", residuals: " << residuals[best] << ", costs: " << pairedCosts[best]);
+    return results[best];
+}
+
+}
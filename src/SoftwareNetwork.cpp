@@ -1,7 +1,143 @@
 #include "SoftwareNetwork.hpp"
+#include <algorithm>
+#include <condition_variable>
+#include <limits>
+#include <mutex>
+#include <thread>
 
 namespace Software {
 
+namespace {
+
+// The indices a worker still has to process. Other workers steal from its end.
+struct IndexRange
+{
+    std::mutex mutex;
+    std::size_t begin;
+    std::size_t end;
+};
+
+// Processes all indices of [first, last) with a pool of work stealing threads
+void stealWork(const std::size_t first, const std::size_t last, const unsigned int threads, const std::function< void (const std::size_t) >& work)
+{
+    const std::size_t n((last > first) ? last - first : 0);
+    if (!n)
+        return;
+    const std::size_t nWorkers(std::max< std::size_t >(1, std::min< std::size_t >(threads, n)));
+    std::vector< IndexRange > ranges(nWorkers);
+    for (std::size_t w = 0; w < nWorkers; ++w)
+    {
+        ranges[w].begin = first + (n / nWorkers) * w + std::min(w, n % nWorkers);
+        ranges[w].end = first + (n / nWorkers) * (w + 1) + std::min(w + 1, n % nWorkers);
+    }
+    auto worker = [&] (const std::size_t self) {
+        while (true)
+        {
+            std::size_t index(0);
+            bool found(false);
+            {
+                std::lock_guard< std::mutex > lock(ranges[self].mutex);
+                if (ranges[self].begin < ranges[self].end)
+                {
+                    index = ranges[self].begin++;
+                    found = true;
+                }
+            }
+            if (found)
+            {
+                work(index);
+                continue;
+            }
+            // Out of work: Steal the upper half of the indices of the next worker which has some left
+            std::size_t stolenBegin(0), stolenEnd(0);
+            for (std::size_t k = 1; (k < nWorkers) && (stolenBegin == stolenEnd); ++k)
+            {
+                IndexRange& victim(ranges[(self + k) % nWorkers]);
+                std::lock_guard< std::mutex > lock(victim.mutex);
+                if (victim.begin < victim.end)
+                {
+                    stolenBegin = victim.begin + (victim.end - victim.begin) / 2;
+                    stolenEnd = victim.end;
+                    victim.end = stolenBegin;
+                }
+            }
+            if (stolenBegin == stolenEnd)
+                return;
+            std::lock_guard< std::mutex > lock(ranges[self].mutex);
+            ranges[self].begin = stolenBegin;
+            ranges[self].end = stolenEnd;
+        }
+    };
+    // The calling thread is the first worker
+    std::vector< std::thread > pool;
+    for (std::size_t w = 1; w < nWorkers; ++w)
+        pool.push_back(std::thread(worker, w));
+    worker(0);
+    for (std::thread& t : pool)
+        t.join();
+}
+
+// Produces the results of all positions of [0, n) with a pool of threads and consumes them one at a time in the order of the positions
+// NOTE: Positions are handed out in ascending order and a worker waits before producing a position too far ahead of the consumed ones.
+// So at most a few results per thread are buffered (and the worker holding the next position to consume never waits).
+// NOTE: The worker which completes the next position takes the run of ready results out of the buffer and consumes it without holding the lock.
+// Meanwhile, the others keep producing, and it continues with the results completed in the meantime.
+void produceInOrder(const std::size_t n, const unsigned int threads, const std::function< std::string (const std::size_t) >& produce, const std::function< void (const std::size_t, const std::string&) >& consume)
+{
+    if (!n)
+        return;
+    const std::size_t nWorkers(std::max< std::size_t >(1, std::min< std::size_t >(threads, n)));
+    const std::size_t window(4 * nWorkers);
+    std::mutex bufferMutex;
+    std::condition_variable consumed;
+    std::map< std::size_t, std::string > ready;
+    std::size_t nextPosition(0);
+    std::size_t nextHandedOut(0);
+    bool consuming(false);
+    auto worker = [&] () {
+        std::unique_lock< std::mutex > lock(bufferMutex);
+        while (nextHandedOut < n)
+        {
+            const std::size_t position(nextHandedOut++);
+            consumed.wait(lock, [&] () { return position < nextPosition + window; });
+            lock.unlock();
+            std::string result(produce(position));
+            lock.lock();
+            ready[position].swap(result);
+            if (consuming)
+                continue;
+            consuming = true;
+            while (!ready.empty() && (ready.begin()->first == nextPosition))
+            {
+                std::vector< std::string > run;
+                while (!ready.empty() && (ready.begin()->first == nextPosition + run.size()))
+                {
+                    run.push_back(std::string());
+                    run.back().swap(ready.begin()->second);
+                    ready.erase(ready.begin());
+                }
+                const std::size_t first(nextPosition);
+                lock.unlock();
+                for (std::size_t i = 0; i < run.size(); ++i)
+                    consume(first + i, run[i]);
+                lock.lock();
+                nextPosition += run.size();
+                consumed.notify_all();
+            }
+            consuming = false;
+        }
+    };
+    // The calling thread is the first worker
+    std::vector< std::thread > pool;
+    for (std::size_t w = 1; w < nWorkers; ++w)
+        pool.push_back(std::thread(worker));
+    worker();
+    for (std::thread& t : pool)
+        t.join();
+}
+
+}
+
 
 // Concept Ids
 const UniqueId Network::InterfaceId       = "Software::Network::Interface";
@@ -77,80 +213,67 @@ Hyperedges Network::createImplementationInterface(const UniqueId& uid, const std
 
 Hyperedges Network::algorithmClasses(const std::string& name, const Hyperedges& suids) const
 {
-    const Hyperedges& all(componentClasses(name, Hyperedges{Network::AlgorithmId}));
-    return suids.empty() ? all : intersect(all, subclassesOf(suids, name));
+    return NetworkView(*this).algorithmClasses(name, suids);
 }
 
 Hyperedges Network::interfaceClasses(const std::string& name, const Hyperedges& suids) const
 {
-    const Hyperedges& all(Component::Network::interfaceClasses(name, Hyperedges{Network::InterfaceId}));
-    return suids.empty() ? all : intersect(all, subclassesOf(suids, name));
+    return NetworkView(*this).interfaceClasses(name, suids);
 }
 
 Hyperedges Network::implementationClasses(const std::string& name, const Hyperedges& suids) const
 {
-    const Hyperedges& all(algorithmClasses(name, Hyperedges{Network::ImplementationId}));
-    return suids.empty() ? all : intersect(all, subclassesOf(suids, name));
+    return NetworkView(*this).implementationClasses(name, suids);
 }
 
 Hyperedges Network::implementationInterfaceClasses(const std::string& name, const Hyperedges& suids) const
 {
-    const Hyperedges& all(Component::Network::interfaceClasses(name, Hyperedges{Network::ImplementationInterfaceId}));
-    return suids.empty() ? all : intersect(all, subclassesOf(suids, name));
+    return NetworkView(*this).implementationInterfaceClasses(name, suids);
 }
 
 Hyperedges Network::algorithms(const std::string& name, const std::string& className) const
 {
-    // Get all super classes
-    const Hyperedges& classIds(algorithmClasses(className));
-    // ... and then the instances of them
-    return instancesOf(classIds, name);
+    return NetworkView(*this).algorithms(name, className);
 }
+
 Hyperedges Network::interfaces(const std::string& name, const std::string& className) const
 {
-    // Get all super classes
-    const Hyperedges& classIds(interfaceClasses(className));
-    // ... and then the instances of them
-    return instancesOf(classIds, name);
+    return NetworkView(*this).interfaces(name, className);
 }
+
 Hyperedges Network::implementationInterfaces(const std::string& name, const std::string& className) const
 {
-    // Get all super classes
-    const Hyperedges& classIds(implementationInterfaceClasses(className));
-    // ... and then the instances of them
-    return instancesOf(classIds, name);
+    return NetworkView(*this).implementationInterfaces(name, className);
 }
+
 Hyperedges Network::implementations(const std::string& name, const std::string& className) const
 {
-    // Get all super classes
-    const Hyperedges& classIds(implementationClasses(className));
-    // ... and then the instances of them
-    return instancesOf(classIds, name);
+    return NetworkView(*this).implementations(name, className);
 }
 
 Hyperedges Network::inputsOf(const Hyperedges& uids, const std::string& name, const TraversalDirection dir) const
 {
-    return relatedTo(uids, Hyperedges{Network::NeedsId}, name, dir);
+    return NetworkView(*this).inputsOf(uids, name, dir);
 }
 
 Hyperedges Network::outputsOf(const Hyperedges& uids, const std::string& name, const TraversalDirection dir) const
 {
-    return relatedTo(uids, Hyperedges{Network::ProvidesId}, name, dir);
+    return NetworkView(*this).outputsOf(uids, name, dir);
 }
 
 Hyperedges Network::implementationsOf(const Hyperedges& uids, const std::string& name, const TraversalDirection dir) const
 {
-    return relatedTo(uids, Hyperedges{Network::ImplementsId}, name, dir);
+    return NetworkView(*this).implementationsOf(uids, name, dir);
 }
 
 Hyperedges Network::encodersOf(const Hyperedges& uids, const std::string& name, const TraversalDirection dir) const
 {
-    return relatedTo(uids, Hyperedges{Network::EncodesId}, name, dir);
+    return NetworkView(*this).encodersOf(uids, name, dir);
 }
 
 Hyperedges Network::realizersOf(const Hyperedges& uids, const std::string& name, const TraversalDirection dir) const
 {
-    return relatedTo(uids, Hyperedges{Network::RealizesId}, name, dir);
+    return NetworkView(*this).realizersOf(uids, name, dir);
 }
 
 Hyperedges Network::providesInterface(const Hyperedges& algorithmIds, const Hyperedges& outputIds)
@@ -249,69 +372,549 @@ Hyperedges Network::realizes(const Hyperedges& implementationIds, const Hyperedg
 std::vector< Software::Network > Software::Network::generateAllImplementationNetworks() const
 {
     std::vector< Software::Network > results;
-    results.push_back(*this);
+    ImplementationNetworks variants(*this);
+    Software::Network variant;
+    while (variants.next(variant))
+        results.push_back(variant);
+    return results;
+}
 
-    // Cycle through all algorithm instances
-    const Hyperedges& algUids(algorithms());
-    for (const UniqueId& algUid : algUids)
+// ImplementationNetworks
+ImplementationNetworks::ImplementationNetworks(const Network& algorithmNetwork)
+: algorithmNetwork(std::make_shared< const Network >(algorithmNetwork)), algorithmUids(algorithmNetwork.algorithms()), numVariants(1), current(0)
+{
+    // Find the implementation classes of all algorithm instances (the radices)
+    for (const UniqueId& algUid : algorithmUids)
     {
-        // Find all implementation classes
-        const Hyperedges& algClassUids(instancesOf(Hyperedges{algUid},"", Hypergraph::TraversalDirection::FORWARD));
-        const Hyperedges& implClassUids(implementationsOf(algClassUids));
+        const Hyperedges& algClassUids(algorithmNetwork.instancesOf(Hyperedges{algUid},"", Hypergraph::TraversalDirection::FORWARD));
+        implementationClassUids.push_back(algorithmNetwork.implementationsOf(algClassUids));
+        const std::size_t radix(implementationClassUids.back().size());
+        if (radix && (numVariants > std::numeric_limits< std::size_t >::max() / radix))
+            numVariants = std::numeric_limits< std::size_t >::max();
+        else
+            numVariants *= radix;
+    }
+    compile();
+}
 
-        // For each possible implementation (except of the first one) we have a new possibility
-        std::vector< Software::Network > newResults;
-        for (const Software::Network& current : results)
-        {
-            for (const UniqueId& implClassUid : implClassUids)
-            {
-                // Store a copy of the current graph before modification
-                Software::Network newResult(current);
+std::size_t ImplementationNetworks::size() const
+{
+    return numVariants;
+}
 
-                // create a new possiblity
-                newResult.realizes(newResult.instantiateComponent(Hyperedges{implClassUid}, newResult.access(algUid).label()), Hyperedges{algUid});
-                newResults.push_back(newResult);
-            }
-        }
-        results = newResults;
+std::vector< std::size_t > ImplementationNetworks::choicesOf(const std::size_t index) const
+{
+    // The last algorithm is the least significant digit
+    std::vector< std::size_t > choices(algorithmUids.size(), 0);
+    std::size_t remainder(index);
+    for (std::size_t i = algorithmUids.size(); i > 0; --i)
+    {
+        const std::size_t radix(implementationClassUids[i-1].size());
+        choices[i-1] = radix ? remainder % radix : 0;
+        remainder = radix ? remainder / radix : 0;
     }
+    return choices;
+}
 
-    // Reconstruct wiring of implementation instances
-    for (const UniqueId& algUid : algUids)
+Network ImplementationNetworks::at(const std::size_t index) const
+{
+    return overlayAt(index).flatten();
+}
+
+NetworkOverlay ImplementationNetworks::overlayAt(const std::size_t index) const
+{
+    NetworkOverlay variant(algorithmNetwork);
+    const std::vector< std::size_t >& choices(choicesOf(index));
+    Hyperedges implUids;
+    for (std::size_t i = 0; i < algorithmUids.size(); ++i)
+        implUids.push_back(variant.realize(implementationClassUids[i][choices[i]], algorithmUids[i]).front());
+    wire(variant, implUids, choices);
+    return variant;
+}
+
+void ImplementationNetworks::forEach(const std::function< void (const std::size_t, const NetworkOverlay&) >& visit, const unsigned int threads, const std::size_t first, const std::size_t last) const
+{
+    stealWork(first, std::min(last, numVariants), threads, [&] (const std::size_t index) {
+        visit(index, overlayAt(index));
+    });
+}
+
+void ImplementationNetworks::forEach(const std::function< void (const std::size_t, const NetworkOverlay&) >& visit, const unsigned int threads, const std::vector< std::size_t >& indices) const
+{
+    stealWork(0, indices.size(), threads, [&] (const std::size_t position) {
+        visit(indices[position], overlayAt(indices[position]));
+    });
+}
+
+void ImplementationNetworks::forEachInOrder(const std::function< std::string (const std::size_t, const NetworkOverlay&) >& produce,
+                                            const std::function< void (const std::size_t, const std::string&) >& consume,
+                                            const unsigned int threads, const std::size_t first, const std::size_t last) const
+{
+    const std::size_t end(std::min(last, numVariants));
+    produceInOrder((end > first) ? end - first : 0, threads,
+        [&] (const std::size_t position) { return produce(first + position, overlayAt(first + position)); },
+        [&] (const std::size_t position, const std::string& result) { consume(first + position, result); });
+}
+
+void ImplementationNetworks::forEachInOrder(const std::function< std::string (const std::size_t, const NetworkOverlay&) >& produce,
+                                            const std::function< void (const std::size_t, const std::string&) >& consume,
+                                            const unsigned int threads, const std::vector< std::size_t >& indices) const
+{
+    produceInOrder(indices.size(), threads,
+        [&] (const std::size_t position) { return produce(indices[position], overlayAt(indices[position])); },
+        [&] (const std::size_t position, const std::string& result) { consume(indices[position], result); });
+}
+
+bool ImplementationNetworks::next(Network& variant)
+{
+    if (current >= numVariants)
+        return false;
+    variant = at(current++);
+    return true;
+}
+
+std::size_t ImplementationNetworks::index() const
+{
+    return current;
+}
+
+void ImplementationNetworks::reset(const std::size_t index)
+{
+    current = index;
+}
+
+void ImplementationNetworks::compile()
+{
+    // Find the interfaces of an implementation class by name (including the ones of its superclasses)
+    const Hyperedges& interfaceUids(algorithmNetwork->interfaces());
+    auto interfacesOf = [&] (const UniqueId& implClassUid, const std::string& label) -> Hyperedges {
+        Hyperedges result;
+        const Hyperedges& superclassUids(algorithmNetwork->subclassesOf(Hyperedges{implClassUid}, "", Hypergraph::TraversalDirection::FORWARD));
+        for (const UniqueId& superclassUid : superclassUids)
+            result = unite(result, intersect(interfaceUids, algorithmNetwork->interfacesOf(Hyperedges{superclassUid}, label)));
+        return result;
+    };
+    for (std::size_t i = 0; i < algorithmUids.size(); ++i)
     {
         // Find interfaces
-        const Hyperedges& algInterfaceUids(interfacesOf(Hyperedges{algUid}));
+        const Hyperedges& algInterfaceUids(algorithmNetwork->interfacesOf(Hyperedges{algorithmUids[i]}));
         for (const UniqueId& algInterfaceUid : algInterfaceUids)
         {
             // Find other interfaces
-            const Hyperedges& endpointUids(endpointsOf(Hyperedges{algInterfaceUid}));
+            const Hyperedges& endpointUids(algorithmNetwork->endpointsOf(Hyperedges{algInterfaceUid}));
             for (const UniqueId& otherAlgInterfaceUid : endpointUids)
             {
                 // Find other algorithms
-                const Hyperedges& otherAlgUids(intersect(algUids, interfacesOf(Hyperedges{otherAlgInterfaceUid}, "", Hypergraph::TraversalDirection::INVERSE)));
+                const Hyperedges& otherAlgUids(intersect(algorithmUids, algorithmNetwork->interfacesOf(Hyperedges{otherAlgInterfaceUid}, "", Hypergraph::TraversalDirection::INVERSE)));
                 for (const UniqueId& otherAlgUid : otherAlgUids)
                 {
                     // We now have algUid -> algInterfaceUid -> otherAlgInterfaceUid -> otherAlgUid
-                    // We have to find implUid -> implInterfaceUid -> otherImplInterfaceUid -> otherImplUid in ALL results
-                    for (Software::Network& current : results)
-                    {
-                        // NOTE: For each result, we have different instances (at most one though)
-                        // To find them, we need to get all facts of Network::RealizedById, which also point from algUid or otherAlgUid
-                        const Hyperedges& implUids(current.realizersOf(Hyperedges{algUid}));
-                        const Hyperedges& otherImplUids(current.realizersOf(Hyperedges{otherAlgUid}));
-                        // Find the correct interfaces ... by ownership & name
-                        const Hyperedges& implInterfaceUids(current.interfacesOf(implUids, access(algInterfaceUid).label()));
-                        const Hyperedges& otherImplInterfaceUids(current.interfacesOf(otherImplUids, access(otherAlgInterfaceUid).label()));
-                        // Wire
-                        // NOTE: implInterfaceUids are inputs, otherImplInterfaceUids are outputs
-                        current.dependsOn(implInterfaceUids, otherImplInterfaceUids);
-                    }
+                    // For every implementation class of both we need implClassUid -> implInterfaceUid ... otherImplInterfaceUid <- otherImplClassUid (by name)
+                    // NOTE: The interfaces of algUid are inputs, the ones of otherAlgUid are outputs
+                    Wire w;
+                    w.inputAlgorithm = i;
+                    w.outputAlgorithm = std::find(algorithmUids.begin(), algorithmUids.end(), otherAlgUid) - algorithmUids.begin();
+                    for (const UniqueId& implClassUid : implementationClassUids[w.inputAlgorithm])
+                        w.inputInterfaceUids.push_back(interfacesOf(implClassUid, algorithmNetwork->access(algInterfaceUid).label()));
+                    for (const UniqueId& implClassUid : implementationClassUids[w.outputAlgorithm])
+                        w.outputInterfaceUids.push_back(interfacesOf(implClassUid, algorithmNetwork->access(otherAlgInterfaceUid).label()));
+                    wiring.push_back(w);
                 }
             }
         }
     }
+}
 
-    return results;
+void ImplementationNetworks::wire(NetworkOverlay& variant, const Hyperedges& implUids, const std::vector< std::size_t >& choices) const
+{
+    // Reconstruct wiring of implementation instances
+    for (const Wire& w : wiring)
+    {
+        for (const UniqueId& inputUid : w.inputInterfaceUids[choices[w.inputAlgorithm]])
+        {
+            for (const UniqueId& outputUid : w.outputInterfaceUids[choices[w.outputAlgorithm]])
+            {
+                variant.factFrom(Hyperedges{NetworkOverlay::cloneOf(implUids[w.outputAlgorithm], outputUid)},
+                                 Hyperedges{NetworkOverlay::cloneOf(implUids[w.inputAlgorithm], inputUid)},
+                                 Network::DependsOnId);
+            }
+        }
+    }
+}
+
+// NetworkView
+NetworkView::NetworkView(const CommonConceptGraph& ccg)
+: Component::NetworkView(ccg)
+{
+}
+
+NetworkView::~NetworkView()
+{
+}
+
+Hyperedges NetworkView::algorithmClasses(const std::string& name, const Hyperedges& suids) const
+{
+    const Hyperedges& all(componentClasses(name, Hyperedges{Network::AlgorithmId}));
+    return suids.empty() ? all : intersect(all, ccg.subclassesOf(suids, name));
+}
+
+Hyperedges NetworkView::interfaceClasses(const std::string& name, const Hyperedges& suids) const
+{
+    const Hyperedges& all(Component::NetworkView::interfaceClasses(name, Hyperedges{Network::InterfaceId}));
+    return suids.empty() ? all : intersect(all, ccg.subclassesOf(suids, name));
+}
+
+Hyperedges NetworkView::implementationClasses(const std::string& name, const Hyperedges& suids) const
+{
+    const Hyperedges& all(algorithmClasses(name, Hyperedges{Network::ImplementationId}));
+    return suids.empty() ? all : intersect(all, ccg.subclassesOf(suids, name));
+}
+
+Hyperedges NetworkView::implementationInterfaceClasses(const std::string& name, const Hyperedges& suids) const
+{
+    const Hyperedges& all(Component::NetworkView::interfaceClasses(name, Hyperedges{Network::ImplementationInterfaceId}));
+    return suids.empty() ? all : intersect(all, ccg.subclassesOf(suids, name));
+}
+
+Hyperedges NetworkView::algorithms(const std::string& name, const std::string& className) const
+{
+    // Get all super classes
+    const Hyperedges& classIds(algorithmClasses(className));
+    // ... and then the instances of them
+    return ccg.instancesOf(classIds, name);
+}
+Hyperedges NetworkView::interfaces(const std::string& name, const std::string& className) const
+{
+    // Get all super classes
+    const Hyperedges& classIds(interfaceClasses(className));
+    // ... and then the instances of them
+    return ccg.instancesOf(classIds, name);
+}
+Hyperedges NetworkView::implementationInterfaces(const std::string& name, const std::string& className) const
+{
+    // Get all super classes
+    const Hyperedges& classIds(implementationInterfaceClasses(className));
+    // ... and then the instances of them
+    return ccg.instancesOf(classIds, name);
+}
+Hyperedges NetworkView::implementations(const std::string& name, const std::string& className) const
+{
+    // Get all super classes
+    const Hyperedges& classIds(implementationClasses(className));
+    // ... and then the instances of them
+    return ccg.instancesOf(classIds, name);
+}
+
+Hyperedges NetworkView::inputsOf(const Hyperedges& uids, const std::string& name, const Hypergraph::TraversalDirection dir) const
+{
+    return ccg.relatedTo(uids, Hyperedges{Network::NeedsId}, name, dir);
+}
+
+Hyperedges NetworkView::outputsOf(const Hyperedges& uids, const std::string& name, const Hypergraph::TraversalDirection dir) const
+{
+    return ccg.relatedTo(uids, Hyperedges{Network::ProvidesId}, name, dir);
+}
+
+Hyperedges NetworkView::implementationsOf(const Hyperedges& uids, const std::string& name, const Hypergraph::TraversalDirection dir) const
+{
+    return ccg.relatedTo(uids, Hyperedges{Network::ImplementsId}, name, dir);
+}
+
+Hyperedges NetworkView::encodersOf(const Hyperedges& uids, const std::string& name, const Hypergraph::TraversalDirection dir) const
+{
+    return ccg.relatedTo(uids, Hyperedges{Network::EncodesId}, name, dir);
+}
+
+Hyperedges NetworkView::realizersOf(const Hyperedges& uids, const std::string& name, const Hypergraph::TraversalDirection dir) const
+{
+    return ccg.relatedTo(uids, Hyperedges{Network::RealizesId}, name, dir);
+}
+
+// NetworkOverlay
+NetworkOverlay::NetworkOverlay(const std::shared_ptr< const Network >& base)
+: baseNetwork(base)
+{
+}
+
+NetworkOverlay::~NetworkOverlay()
+{
+}
+
+const Network& NetworkOverlay::base() const
+{
+    return *baseNetwork;
+}
+
+Hyperedges NetworkOverlay::realize(const UniqueId& implementationClassUid, const UniqueId& algorithmUid)
+{
+    // Mirrors instantiateComponent, but only records the new individuals and facts
+    const UniqueId implUid(algorithmUid + "/" + implementationClassUid);
+    const Hyperedges& hasAUids(baseNetwork->subrelationsOf(Hyperedges{CommonConceptGraph::HasAId}));
+    individual(implUid, baseNetwork->access(algorithmUid).label(), Hyperedges{implementationClassUid});
+    const Hyperedges& superclassUids(baseNetwork->subclassesOf(Hyperedges{implementationClassUid}, "", Hypergraph::FORWARD));
+    for (const UniqueId& superclassUid : superclassUids)
+    {
+        const Hyperedges& descUids(baseNetwork->descendantsOf(Hyperedges{superclassUid}));
+        for (const UniqueId& descUid : descUids)
+        {
+            individual(cloneOf(implUid, descUid), baseNetwork->access(descUid).label(), baseNetwork->instancesOf(Hyperedges{descUid}, "", Hypergraph::FORWARD));
+            if (!baseNetwork->factsOf(hasAUids, Hyperedges{superclassUid}, Hyperedges{descUid}).empty())
+                facts.push_back(Fact{implUid, cloneOf(implUid, descUid), "", superclassUid, descUid});
+        }
+        for (const UniqueId& srcUid : descUids)
+        {
+            for (const UniqueId& dstUid : descUids)
+            {
+                if (!baseNetwork->factsOf(hasAUids, Hyperedges{srcUid}, Hyperedges{dstUid}).empty())
+                    facts.push_back(Fact{cloneOf(implUid, srcUid), cloneOf(implUid, dstUid), "", srcUid, dstUid});
+            }
+        }
+    }
+    facts.push_back(Fact{implUid, algorithmUid, Network::RealizesId, "", ""});
+    return Hyperedges{implUid};
+}
+
+void NetworkOverlay::dependsOn(const Hyperedges& inputIds, const Hyperedges& outputIds)
+{
+    // For now only input instances can depend on output instances
+    const Hyperedges& fromIds(intersect(interfaces(), inputIds));
+    const Hyperedges& toIds(intersect(interfaces(), outputIds));
+    for (const UniqueId& fromId : fromIds)
+    {
+        for (const UniqueId& toId : toIds)
+        {
+            factFrom(Hyperedges{toId}, Hyperedges{fromId}, Network::DependsOnId);
+        }
+    }
+}
+
+void NetworkOverlay::factFrom(const Hyperedges& fromIds, const Hyperedges& toIds, const UniqueId& relUid)
+{
+    for (const UniqueId& fromId : fromIds)
+        for (const UniqueId& toId : toIds)
+            facts.push_back(Fact{fromId, toId, relUid, "", ""});
+}
+
+UniqueId NetworkOverlay::cloneOf(const UniqueId& instanceUid, const UniqueId& descendantUid)
+{
+    return instanceUid + "/" + descendantUid;
+}
+
+void NetworkOverlay::remove(const Hyperedges& uids)
+{
+    for (const UniqueId& uid : uids)
+    {
+        if (individuals.erase(uid))
+        {
+            // The clones of realize() (see cloneOf) share the prefix of the instance
+            const UniqueId prefix(uid + "/");
+            std::map< UniqueId, Individual >::iterator it(individuals.lower_bound(prefix));
+            while ((it != individuals.end()) && (it->first.compare(0, prefix.size(), prefix) == 0))
+                it = individuals.erase(it);
+            continue;
+        }
+        if (baseNetwork->exists(uid))
+            hiddenUids = unite(hiddenUids, Hyperedges{uid});
+    }
+    // Drop the facts of removed individuals
+    std::vector< Fact > remaining;
+    for (const Fact& fact : facts)
+    {
+        if (exists(fact.fromUid) && exists(fact.toUid))
+            remaining.push_back(fact);
+    }
+    facts.swap(remaining);
+}
+
+std::size_t NetworkOverlay::deltaSize() const
+{
+    return individuals.size() + facts.size() + hiddenUids.size();
+}
+
+void NetworkOverlay::apply(CommonConceptGraph& ccg) const
+{
+    for (const UniqueId& uid : hiddenUids)
+        ccg.destroy(uid);
+    for (const auto& entry : individuals)
+    {
+        ccg.concept(entry.first, entry.second.edge.label());
+        for (const UniqueId& classUid : entry.second.classUids)
+            ccg.factFrom(Hyperedges{entry.first}, Hyperedges{classUid}, CommonConceptGraph::InstanceOfId);
+    }
+    const Hyperedges& hasAUids(ccg.subrelationsOf(Hyperedges{CommonConceptGraph::HasAId}));
+    for (const Fact& fact : facts)
+    {
+        if (fact.relationUid.empty())
+            ccg.factFromAnother(Hyperedges{fact.fromUid}, Hyperedges{fact.toUid}, ccg.factsOf(hasAUids, Hyperedges{fact.templateFromUid}, Hyperedges{fact.templateToUid}));
+        else
+            ccg.factFrom(Hyperedges{fact.fromUid}, Hyperedges{fact.toUid}, fact.relationUid);
+    }
+}
+
+Network NetworkOverlay::flatten() const
+{
+    Network result(*baseNetwork);
+    apply(result);
+    return result;
+}
+
+bool NetworkOverlay::exists(const UniqueId& uid) const
+{
+    if (individuals.count(uid))
+        return true;
+    return baseNetwork->exists(uid) && !std::count(hiddenUids.begin(), hiddenUids.end(), uid);
+}
+
+const Hyperedge& NetworkOverlay::access(const UniqueId& uid) const
+{
+    const auto& it(individuals.find(uid));
+    return (it != individuals.end()) ? it->second.edge : baseNetwork->access(uid);
+}
+
+Hyperedges NetworkOverlay::instancesOf(const Hyperedges& uids, const std::string& name, const Hypergraph::TraversalDirection dir) const
+{
+    Hyperedges result(visible(baseNetwork->instancesOf(uids, name, dir)));
+    for (const auto& entry : individuals)
+    {
+        if (dir != Hypergraph::FORWARD)
+        {
+            // Instances of the given classes
+            if (matches(entry.first, name) && !intersect(entry.second.classUids, uids).empty())
+                result = unite(result, Hyperedges{entry.first});
+        }
+        if (dir != Hypergraph::INVERSE)
+        {
+            // Classes of the given instances
+            if (std::count(uids.begin(), uids.end(), entry.first))
+                for (const UniqueId& classUid : entry.second.classUids)
+                    if (matches(classUid, name))
+                        result = unite(result, Hyperedges{classUid});
+        }
+    }
+    return result;
+}
+
+Hyperedges NetworkOverlay::relatedTo(const Hyperedges& uids, const Hyperedges& relUids, const std::string& name, const Hypergraph::TraversalDirection dir) const
+{
+    Hyperedges result(visible(baseNetwork->relatedTo(uids, relUids, name, dir)));
+    const Hyperedges& relationUids(baseNetwork->subrelationsOf(relUids));
+    for (const Fact& fact : facts)
+    {
+        if (!isOneOf(fact, relationUids))
+            continue;
+        if ((dir != Hypergraph::INVERSE) && std::count(uids.begin(), uids.end(), fact.fromUid) && matches(fact.toUid, name))
+            result = unite(result, Hyperedges{fact.toUid});
+        if ((dir != Hypergraph::FORWARD) && std::count(uids.begin(), uids.end(), fact.toUid) && matches(fact.fromUid, name))
+            result = unite(result, Hyperedges{fact.fromUid});
+    }
+    return result;
+}
+
+Hyperedges NetworkOverlay::algorithmClasses(const std::string& name, const Hyperedges& suids) const
+{
+    return NetworkView(*baseNetwork).algorithmClasses(name, suids);
+}
+
+Hyperedges NetworkOverlay::interfaceClasses(const std::string& name, const Hyperedges& suids) const
+{
+    return NetworkView(*baseNetwork).interfaceClasses(name, suids);
+}
+
+Hyperedges NetworkOverlay::implementationClasses(const std::string& name, const Hyperedges& suids) const
+{
+    return NetworkView(*baseNetwork).implementationClasses(name, suids);
+}
+
+Hyperedges NetworkOverlay::implementationInterfaceClasses(const std::string& name, const Hyperedges& suids) const
+{
+    return NetworkView(*baseNetwork).implementationInterfaceClasses(name, suids);
+}
+
+Hyperedges NetworkOverlay::components(const std::string& name, const std::string& className) const
+{
+    return instancesOf(NetworkView(*baseNetwork).componentClasses(className), name);
+}
+
+Hyperedges NetworkOverlay::algorithms(const std::string& name, const std::string& className) const
+{
+    return instancesOf(algorithmClasses(className), name);
+}
+
+Hyperedges NetworkOverlay::interfaces(const std::string& name, const std::string& className) const
+{
+    return instancesOf(interfaceClasses(className), name);
+}
+
+Hyperedges NetworkOverlay::implementations(const std::string& name, const std::string& className) const
+{
+    return instancesOf(implementationClasses(className), name);
+}
+
+Hyperedges NetworkOverlay::implementationInterfaces(const std::string& name, const std::string& className) const
+{
+    return instancesOf(implementationInterfaceClasses(className), name);
+}
+
+Hyperedges NetworkOverlay::interfacesOf(const Hyperedges& uids, const std::string& name, const Hypergraph::TraversalDirection dir) const
+{
+    return relatedTo(uids, Hyperedges{Component::Network::HasAInterfaceId}, name, dir);
+}
+
+Hyperedges NetworkOverlay::subinterfacesOf(const Hyperedges& uids, const std::string& name, const Hypergraph::TraversalDirection dir) const
+{
+    return relatedTo(uids, Hyperedges{Component::Network::HasASubInterfaceId}, name, dir);
+}
+
+Hyperedges NetworkOverlay::endpointsOf(const Hyperedges& uids, const std::string& name, const Hypergraph::TraversalDirection dir) const
+{
+    return relatedTo(uids, Hyperedges{CommonConceptGraph::ConnectsId}, name, dir);
+}
+
+Hyperedges NetworkOverlay::inputsOf(const Hyperedges& uids, const std::string& name, const Hypergraph::TraversalDirection dir) const
+{
+    return relatedTo(uids, Hyperedges{Network::NeedsId}, name, dir);
+}
+
+Hyperedges NetworkOverlay::outputsOf(const Hyperedges& uids, const std::string& name, const Hypergraph::TraversalDirection dir) const
+{
+    return relatedTo(uids, Hyperedges{Network::ProvidesId}, name, dir);
+}
+
+Hyperedges NetworkOverlay::implementationsOf(const Hyperedges& uids, const std::string& name, const Hypergraph::TraversalDirection dir) const
+{
+    return relatedTo(uids, Hyperedges{Network::ImplementsId}, name, dir);
+}
+
+Hyperedges NetworkOverlay::encodersOf(const Hyperedges& uids, const std::string& name, const Hypergraph::TraversalDirection dir) const
+{
+    return relatedTo(uids, Hyperedges{Network::EncodesId}, name, dir);
+}
+
+Hyperedges NetworkOverlay::realizersOf(const Hyperedges& uids, const std::string& name, const Hypergraph::TraversalDirection dir) const
+{
+    return relatedTo(uids, Hyperedges{Network::RealizesId}, name, dir);
+}
+
+void NetworkOverlay::individual(const UniqueId& uid, const std::string& label, const Hyperedges& classUids)
+{
+    individuals.insert(std::make_pair(uid, Individual{Hyperedge(uid, label), classUids}));
+}
+
+bool NetworkOverlay::isOneOf(const Fact& fact, const Hyperedges& relationUids) const
+{
+    if (!fact.relationUid.empty())
+        return std::count(relationUids.begin(), relationUids.end(), fact.relationUid) > 0;
+    return !baseNetwork->factsOf(relationUids, Hyperedges{fact.templateFromUid}, Hyperedges{fact.templateToUid}).empty();
+}
+
+bool NetworkOverlay::matches(const UniqueId& uid, const std::string& name) const
+{
+    return name.empty() || (exists(uid) && (access(uid).label() == name));
+}
+
+Hyperedges NetworkOverlay::visible(const Hyperedges& uids) const
+{
+    return hiddenUids.empty() ? uids : subtract(uids, hiddenUids);
 }
 
 }
@@ -2,16 +2,23 @@
 #include "catch.hpp"
 #include "ComponentNetwork.hpp"
 #include "ResourceCostModel.hpp"
+#include "ResourceCostSolver.hpp"
 
 #include "SoftwareNetwork.hpp"
 #include "HardwareComputationalNetwork.hpp"
 #include "HypergraphYAML.hpp"
 
 #include "Mapper.hpp"
+#include "Diagnostics.hpp"
 
+#include <cstdio>
+#include <cstdlib>
 #include <fstream>
 #include <iostream>
 #include <limits>
+#include <sstream>
+#include <thread>
+#include <unistd.h>
 
 TEST_CASE("Perform simple mapping of component networks using resource cost model", "[SimpleMapping]")
 {
@@ -51,6 +58,300 @@ TEST_CASE("Perform simple mapping of component networks using resource cost mode
     }
 }
 
+TEST_CASE("Keep resource amounts in the resource ledger", "[ResourceLedger]")
+{
+    ResourceCost::Model rm;
+    rm.defineResource("Resource::Class::Bytes", "Bytes");
+    const Hyperedges& tiny(rm.instantiateResource(rm.concepts("Bytes"), 1e-7f));
+    const Hyperedges& huge(rm.instantiateResource(rm.concepts("Bytes"), 68719476735.f));
+    REQUIRE(rm.amountOf(tiny[0]) == 1e-7f);
+    REQUIRE(rm.amountOf(huge[0]) == 68719476735.f);
+    // Amounts have to survive serialization
+    const ResourceCost::Model rm2(YAML::Load(YAML::StringFrom(rm)).as<Hypergraph>());
+    REQUIRE(rm2.amountOf(tiny[0]) == 1e-7f);
+    REQUIRE(rm2.amountOf(huge[0]) == 68719476735.f);
+    // Changing an amount updates the graph as well
+    rm.amountOf(tiny[0], 0.5f);
+    REQUIRE(ResourceCost::Model(rm).amountOf(tiny[0]) == 0.5f);
+    REQUIRE(ResourceCost::Model(static_cast<const Hypergraph&>(rm)).amountOf(tiny[0]) == 0.5f);
+}
+
+TEST_CASE("Book and release consumed resources when mapping and unmapping", "[ResourceUsage]")
+{
+    ResourceCost::Model rm;
+    rm.defineResource("Resource::Class::A", "Apples");
+    rm.concept("Consumer::a", "a");
+    rm.concept("Consumer::b", "b");
+    rm.concept("Provider::1", "1");
+    rm.isConsumer(Hyperedges{"Consumer::a", "Consumer::b"});
+    rm.isProvider(Hyperedges{"Provider::1"});
+    const Hyperedges& apples(rm.instantiateResource(rm.concepts("Apples"), 4.f));
+    rm.provides(Hyperedges{"Provider::1"}, apples);
+    rm.consumes(Hyperedges{"Consumer::a"}, rm.instantiateResource(rm.concepts("Apples"), 1.f));
+    rm.consumes(Hyperedges{"Consumer::b"}, rm.instantiateResource(rm.concepts("Apples"), 3.f));
+    REQUIRE(rm.usageOf(apples[0]) == 0.f);
+    // Map and check the running totals
+    REQUIRE(rm.mapTo(Hyperedges{"Consumer::a"}, Hyperedges{"Provider::1"}).size() == 1);
+    REQUIRE(rm.usageOf(apples[0]) == 1.f);
+    REQUIRE(rm.satisfies(Hyperedges{"Provider::1"}, Hyperedges{"Consumer::b"}) == 0.f);
+    rm.mapTo(Hyperedges{"Consumer::b"}, Hyperedges{"Provider::1"});
+    REQUIRE(rm.usageOf(apples[0]) == 4.f);
+    REQUIRE(rm.satisfies(Hyperedges{"Provider::1"}, Hyperedges{"Consumer::a"}) < 0.f);
+    // A model constructed from the graph has to restore the totals
+    REQUIRE(ResourceCost::Model(static_cast<const Hypergraph&>(rm)).usageOf(apples[0]) == 4.f);
+    // Unmap and check again
+    REQUIRE(rm.unmap(Hyperedges{"Consumer::b"}) == Hyperedges{"Provider::1"});
+    REQUIRE(rm.providersOf(Hyperedges{"Consumer::b"}).empty());
+    REQUIRE(rm.usageOf(apples[0]) == 1.f);
+    REQUIRE(rm.satisfies(Hyperedges{"Provider::1"}, Hyperedges{"Consumer::b"}) == 0.f);
+}
+
+TEST_CASE("Serve resource demands by compatible resource classes", "[ResourceClasses]")
+{
+    ResourceCost::Model rm;
+    rm.defineResource("Resource::Class::Memory", "Memory");
+    rm.defineResource("Resource::Class::RAM", "RAM", Hyperedges{"Resource::Class::Memory"});
+    rm.defineResource("Resource::Class::Flash", "Flash", Hyperedges{"Resource::Class::Memory"});
+    rm.concept("Consumer::any", "any");
+    rm.concept("Consumer::ram", "ram");
+    rm.concept("Consumer::flash", "flash");
+    rm.concept("Provider::1", "1");
+    rm.concept("Provider::2", "2");
+    rm.isConsumer(Hyperedges{"Consumer::any", "Consumer::ram", "Consumer::flash"});
+    rm.isProvider(Hyperedges{"Provider::1", "Provider::2"});
+    const Hyperedges& ram(rm.instantiateResource(rm.concepts("RAM"), 8.f));
+    const Hyperedges& memory(rm.instantiateResource(rm.concepts("Memory"), 8.f));
+    rm.provides(Hyperedges{"Provider::1"}, ram);
+    rm.provides(Hyperedges{"Provider::2"}, memory);
+    const Hyperedges& anyMemory(rm.instantiateResource(rm.concepts("Memory"), 2.f));
+    const Hyperedges& someRam(rm.instantiateResource(rm.concepts("RAM"), 2.f));
+    rm.consumes(Hyperedges{"Consumer::any"}, anyMemory);
+    rm.consumes(Hyperedges{"Consumer::ram"}, someRam);
+    rm.consumes(Hyperedges{"Consumer::flash"}, rm.instantiateResource(rm.concepts("Flash"), 2.f));
+    REQUIRE(rm.resourceClassIdOf("Resource::Class::RAM") >= 0);
+    REQUIRE(rm.resourceClassIdOf("Consumer::any") < 0);
+    // RAM is memory but memory is not necessarily RAM
+    REQUIRE(rm.compatible(anyMemory[0], ram[0]));
+    REQUIRE(!rm.compatible(someRam[0], memory[0]));
+    REQUIRE(rm.satisfies(Hyperedges{"Provider::1"}, Hyperedges{"Consumer::any"}) >= 0.f);
+    REQUIRE(rm.satisfies(Hyperedges{"Provider::1"}, Hyperedges{"Consumer::ram"}) >= 0.f);
+    REQUIRE(rm.satisfies(Hyperedges{"Provider::1"}, Hyperedges{"Consumer::flash"}) < 0.f);
+    REQUIRE(rm.satisfies(Hyperedges{"Provider::2"}, Hyperedges{"Consumer::any"}) >= 0.f);
+    REQUIRE(rm.satisfies(Hyperedges{"Provider::2"}, Hyperedges{"Consumer::ram"}) < 0.f);
+    // Usage is booked on compatible resources only
+    rm.mapTo(Hyperedges{"Consumer::any", "Consumer::ram"}, Hyperedges{"Provider::1"});
+    REQUIRE(rm.usageOf(ram[0]) == 4.f);
+    REQUIRE(ResourceCost::Model(static_cast<const Hypergraph&>(rm)).usageOf(ram[0]) == 4.f);
+}
+
+TEST_CASE("Evaluate consumers against packed providers", "[ResourcePacking]")
+{
+    ResourceCost::Model rm;
+    rm.defineResource("Resource::Class::Cores", "Cores");
+    rm.defineResource("Resource::Class::Memory", "Memory");
+    rm.defineResource("Resource::Class::RAM", "RAM", Hyperedges{"Resource::Class::Memory"});
+    Hyperedges providerUids;
+    for (int i = 0; i < 11; ++i)
+    {
+        const UniqueId providerUid("Provider::" + std::to_string(i));
+        rm.concept(providerUid, std::to_string(i));
+        rm.isProvider(Hyperedges{providerUid});
+        rm.provides(Hyperedges{providerUid}, rm.instantiateResource(rm.concepts("Cores"), 1.f + i % 4));
+        if (i % 3)
+            rm.provides(Hyperedges{providerUid}, rm.instantiateResource(rm.concepts("RAM"), 10.f * i));
+        providerUids.push_back(providerUid);
+    }
+    Hyperedges consumerUids;
+    for (int i = 0; i < 5; ++i)
+    {
+        const UniqueId consumerUid("Consumer::" + std::to_string(i));
+        rm.concept(consumerUid, std::to_string(i));
+        rm.isConsumer(Hyperedges{consumerUid});
+        rm.consumes(Hyperedges{consumerUid}, rm.instantiateResource(rm.concepts("Cores"), 1.f + i % 2));
+        if (i % 2)
+            rm.needs(Hyperedges{consumerUid}, rm.instantiateResource(rm.concepts("Memory"), 15.f * i));
+        consumerUids.push_back(consumerUid);
+    }
+    rm.pack(consumerUids, providerUids);
+    REQUIRE(rm.isPacked());
+    REQUIRE(rm.packedStride() == 16);
+    REQUIRE(rm.capacities().size() == rm.residuals().size());
+    REQUIRE(rm.capacities().size() % rm.packedStride() == 0);
+    REQUIRE(rm.demands().size() == rm.capacities().size() / rm.packedStride() * consumerUids.size());
+    // The kernel has to agree with satisfies()
+    for (const UniqueId& consumerUid : consumerUids)
+    {
+        std::vector< float > slack;
+        REQUIRE(rm.fits(consumerUid, slack));
+        REQUIRE(slack.size() == providerUids.size());
+        for (std::size_t p = 0; p < providerUids.size(); ++p)
+        {
+            const float expected(rm.satisfies(Hyperedges{providerUids[p]}, Hyperedges{consumerUid}));
+            REQUIRE((slack[p] < 0.f) == (expected < 0.f));
+            if (expected >= 0.f)
+                REQUIRE(slack[p] == expected);
+        }
+    }
+    // Precomputed scores have to agree as well
+    rm.precompute(3);
+    for (const UniqueId& consumerUid : consumerUids)
+    {
+        for (const UniqueId& providerUid : providerUids)
+        {
+            const float expected(rm.satisfies(Hyperedges{providerUid}, Hyperedges{consumerUid}));
+            REQUIRE((rm.fits(consumerUid, providerUid) < 0.f) == (expected < 0.f));
+        }
+    }
+    // Residuals follow the mappings
+    rm.mapTo(Hyperedges{consumerUids[1]}, Hyperedges{providerUids[2]});
+    REQUIRE(rm.isPacked());
+    REQUIRE(rm.fits(consumerUids[1], providerUids[2]) < 0.f);
+    REQUIRE(rm.fits(consumerUids[4], providerUids[2]) == rm.satisfies(Hyperedges{providerUids[2]}, Hyperedges{consumerUids[4]}));
+    rm.unmap(Hyperedges{consumerUids[1]});
+    REQUIRE(rm.fits(consumerUids[1], providerUids[2]) == rm.satisfies(Hyperedges{providerUids[2]}, Hyperedges{consumerUids[1]}));
+    // Other changes unpack the model
+    rm.amountOf(rm.demandsOf(Hyperedges{consumerUids[0]})[0], 2.f);
+    REQUIRE(!rm.isPacked());
+}
+
+// In the following test, consumers and providers are classes (not instances) and have to be considered in a fixed order
+static Hyperedges consumerClassesOf(const ResourceCost::Model& rcm)
+{
+    return intersect(Hyperedges{"Consumer::A", "Consumer::B", "Consumer::C", "Consumer::D"}, rcm.consumerClasses());
+}
+
+static Hyperedges providerClassesOf(const ResourceCost::Model& rcm)
+{
+    return intersect(Hyperedges{"Provider::X", "Provider::Y"}, rcm.providerClasses());
+}
+
+TEST_CASE("Assign consumers to providers with different solvers", "[ResourceSolvers]")
+{
+    ResourceCost::Model rm;
+    rm.defineResource("Resource::Class::Cores", "Cores");
+    rm.defineResource("Resource::Class::Special", "Special");
+    rm.concept("Provider::X", "X");
+    rm.concept("Provider::Y", "Y");
+    rm.isProvider(Hyperedges{"Provider::X", "Provider::Y"});
+    rm.provides(Hyperedges{"Provider::X"}, rm.instantiateResource(rm.concepts("Cores"), 2.f));
+    rm.provides(Hyperedges{"Provider::Y"}, rm.instantiateResource(rm.concepts("Cores"), 3.f));
+    rm.provides(Hyperedges{"Provider::Y"}, rm.instantiateResource(rm.concepts("Special"), 1.f));
+    // Every consumer consumes one core, but B, C and D also need the special resource
+    for (const std::string& name : {"A", "B", "C", "D"})
+    {
+        rm.concept("Consumer::" + name, name);
+        rm.isConsumer(Hyperedges{"Consumer::" + name});
+        rm.consumes(Hyperedges{"Consumer::" + name}, rm.instantiateResource(rm.concepts("Cores"), 1.f));
+    }
+    rm.needs(Hyperedges{"Consumer::B", "Consumer::C", "Consumer::D"}, rm.instantiateResource(rm.concepts("Special"), 1.f));
+
+    // Greedy puts A on Y (more slack) and strands D
+    const ResourceCost::Solver greedy;
+    const ResourceCost::Model greedyResult(greedy.solve(rm, consumerClassesOf, providerClassesOf, ResourceCost::Model::matchFunc, ResourceCost::Model::mapFunc));
+    REQUIRE(greedyResult.providersOf(Hyperedges{"Consumer::D"}).empty());
+    // Min-cost flow maps everyone
+    const ResourceCost::AssignmentSolver mincostflow(ResourceCost::AssignmentSolver::UNIFORM_DEMANDS);
+    REQUIRE(mincostflow.name() == "mincostflow");
+    const ResourceCost::Model flowResult(mincostflow.solve(rm, consumerClassesOf, providerClassesOf, ResourceCost::Model::matchFunc, ResourceCost::Model::mapFunc, 2));
+    REQUIRE(flowResult.consumersOf(Hyperedges{"Provider::X"}).size() + flowResult.consumersOf(Hyperedges{"Provider::Y"}).size() == 4);
+    REQUIRE(flowResult.providersOf(Hyperedges{"Consumer::A"}) == Hyperedges{"Provider::X"});
+    REQUIRE(flowResult.providersOf(Hyperedges{"Consumer::B", "Consumer::C", "Consumer::D"}) == Hyperedges{"Provider::Y"});
+    REQUIRE(flowResult.usageOf(flowResult.resourcesOf(Hyperedges{"Provider::X"})[0]) == 1.f);
+    REQUIRE(flowResult.usageOf(flowResult.resourcesOf(Hyperedges{"Provider::Y"}, flowResult.concepts("Cores"))[0]) == 3.f);
+
+    // With one consumer per provider, the Hungarian assignment avoids the trap of the greedy one as well
+    ResourceCost::Model unit;
+    unit.defineResource("Resource::Class::Cores", "Cores");
+    unit.concept("Provider::X", "X");
+    unit.concept("Provider::Y", "Y");
+    unit.concept("Consumer::A", "A");
+    unit.concept("Consumer::B", "B");
+    unit.isProvider(Hyperedges{"Provider::X", "Provider::Y"});
+    unit.isConsumer(Hyperedges{"Consumer::A", "Consumer::B"});
+    unit.provides(Hyperedges{"Provider::X"}, unit.instantiateResource(unit.concepts("Cores"), 4.f));
+    unit.provides(Hyperedges{"Provider::Y"}, unit.instantiateResource(unit.concepts("Cores"), 2.f));
+    unit.consumes(Hyperedges{"Consumer::A"}, unit.instantiateResource(unit.concepts("Cores"), 2.f));
+    unit.consumes(Hyperedges{"Consumer::B"}, unit.instantiateResource(unit.concepts("Cores"), 3.f));
+    const ResourceCost::Model greedyUnit(greedy.solve(unit, consumerClassesOf, providerClassesOf, ResourceCost::Model::matchFunc, ResourceCost::Model::mapFunc));
+    REQUIRE(greedyUnit.providersOf(Hyperedges{"Consumer::B"}).empty());
+    const ResourceCost::AssignmentSolver hungarian(ResourceCost::AssignmentSolver::UNIT_CAPACITY);
+    const ResourceCost::Model hungarianUnit(hungarian.solve(unit, consumerClassesOf, providerClassesOf, ResourceCost::Model::matchFunc, ResourceCost::Model::mapFunc));
+    REQUIRE(hungarianUnit.providersOf(Hyperedges{"Consumer::A"}) == Hyperedges{"Provider::Y"});
+    REQUIRE(hungarianUnit.providersOf(Hyperedges{"Consumer::B"}) == Hyperedges{"Provider::X"});
+
+    // Branch and bound finds the optimal solutions as well ...
+    const ResourceCost::BranchAndBoundSolver branchAndBound(10.0);
+    REQUIRE(branchAndBound.name() == "branchandbound");
+    const ResourceCost::Model bnbResult(branchAndBound.solve(rm, consumerClassesOf, providerClassesOf, ResourceCost::Model::matchFunc, ResourceCost::Model::mapFunc));
+    REQUIRE(bnbResult.providersOf(Hyperedges{"Consumer::A"}) == Hyperedges{"Provider::X"});
+    REQUIRE(bnbResult.providersOf(Hyperedges{"Consumer::B", "Consumer::C", "Consumer::D"}) == Hyperedges{"Provider::Y"});
+    const ResourceCost::Model bnbUnit(branchAndBound.solve(unit, consumerClassesOf, providerClassesOf, ResourceCost::Model::matchFunc, ResourceCost::Model::mapFunc));
+    REQUIRE(bnbUnit.providersOf(Hyperedges{"Consumer::A"}) == Hyperedges{"Provider::Y"});
+    REQUIRE(bnbUnit.providersOf(Hyperedges{"Consumer::B"}) == Hyperedges{"Provider::X"});
+    // ... but without any budget, it returns the greedy incumbent
+    const ResourceCost::BranchAndBoundSolver noBudget(0.0);
+    const ResourceCost::Model incumbent(noBudget.solve(unit, consumerClassesOf, providerClassesOf, ResourceCost::Model::matchFunc, ResourceCost::Model::mapFunc));
+    REQUIRE(incumbent.providersOf(Hyperedges{"Consumer::A"}) == greedyUnit.providersOf(Hyperedges{"Consumer::A"}));
+    REQUIRE(incumbent.providersOf(Hyperedges{"Consumer::B"}).empty());
+
+    // Annealing repairs the greedy solutions as well and is reproducible
+    const ResourceCost::AnnealingSolver annealing(42, 2000);
+    REQUIRE(annealing.name() == "annealing");
+    const ResourceCost::Model annealed(annealing.solve(rm, consumerClassesOf, providerClassesOf, ResourceCost::Model::matchFunc, ResourceCost::Model::mapFunc));
+    REQUIRE(annealed.providersOf(Hyperedges{"Consumer::A"}) == Hyperedges{"Provider::X"});
+    REQUIRE(annealed.providersOf(Hyperedges{"Consumer::B", "Consumer::C", "Consumer::D"}) == Hyperedges{"Provider::Y"});
+    REQUIRE(annealed.usageOf(annealed.resourcesOf(Hyperedges{"Provider::Y"}, annealed.concepts("Cores"))[0]) == 3.f);
+    ResourceCost::Model improved(greedyUnit);
+    REQUIRE(annealing.improve(improved, consumerClassesOf, providerClassesOf, ResourceCost::Model::matchFunc, ResourceCost::Model::mapFunc) > 0.0);
+    REQUIRE(improved.providersOf(Hyperedges{"Consumer::A"}) == Hyperedges{"Provider::Y"});
+    REQUIRE(improved.providersOf(Hyperedges{"Consumer::B"}) == Hyperedges{"Provider::X"});
+
+    // Multi start greedy finds the solutions by reordering: most constrained first (rm) and largest demands first (unit)
+    const ResourceCost::MultiStartSolver multiStart(6, 3);
+    REQUIRE(multiStart.name() == "multistart");
+    const ResourceCost::Model multiResult(multiStart.solve(rm, consumerClassesOf, providerClassesOf, ResourceCost::Model::matchFunc, ResourceCost::Model::mapFunc, 3));
+    REQUIRE(multiResult.providersOf(Hyperedges{"Consumer::A"}) == Hyperedges{"Provider::X"});
+    REQUIRE(multiResult.providersOf(Hyperedges{"Consumer::B", "Consumer::C", "Consumer::D"}) == Hyperedges{"Provider::Y"});
+    const ResourceCost::Model multiUnit(multiStart.solve(unit, consumerClassesOf, providerClassesOf, ResourceCost::Model::matchFunc, ResourceCost::Model::mapFunc, 3));
+    REQUIRE(multiUnit.providersOf(Hyperedges{"Consumer::A"}) == Hyperedges{"Provider::Y"});
+    REQUIRE(multiUnit.providersOf(Hyperedges{"Consumer::B"}) == Hyperedges{"Provider::X"});
+    // The result does not depend on the number of threads
+    const ResourceCost::Model multiSequential(multiStart.solve(rm, consumerClassesOf, providerClassesOf, ResourceCost::Model::matchFunc, ResourceCost::Model::mapFunc));
+    for (const std::string& name : {"A", "B", "C", "D"})
+    {
+        REQUIRE(multiSequential.providersOf(Hyperedges{"Consumer::" + name}) == multiResult.providersOf(Hyperedges{"Consumer::" + name}));
+    }
+}
+
+TEST_CASE("Balance the load of providers by annealing", "[ResourceAnnealing]")
+{
+    ResourceCost::Model rm;
+    rm.defineResource("Resource::Class::Cores", "Cores");
+    rm.concept("Provider::X", "X");
+    rm.concept("Provider::Y", "Y");
+    rm.isProvider(Hyperedges{"Provider::X", "Provider::Y"});
+    rm.provides(Hyperedges{"Provider::X"}, rm.instantiateResource(rm.concepts("Cores"), 10.f));
+    rm.provides(Hyperedges{"Provider::Y"}, rm.instantiateResource(rm.concepts("Cores"), 10.f));
+    for (const std::string& name : {"A", "B", "C", "D"})
+    {
+        rm.concept("Consumer::" + name, name);
+        rm.isConsumer(Hyperedges{"Consumer::" + name});
+        rm.consumes(Hyperedges{"Consumer::" + name}, rm.instantiateResource(rm.concepts("Cores"), 2.f));
+    }
+    // Put everything on X
+    rm.mapTo(Hyperedges{"Consumer::A", "Consumer::B", "Consumer::C", "Consumer::D"}, Hyperedges{"Provider::X"});
+    const UniqueId x(rm.resourcesOf(Hyperedges{"Provider::X"})[0]);
+    const UniqueId y(rm.resourcesOf(Hyperedges{"Provider::Y"})[0]);
+    REQUIRE(rm.usageOf(x) == 8.f);
+    const ResourceCost::AnnealingSolver annealing(7, 2000);
+    REQUIRE(annealing.improve(rm, consumerClassesOf, providerClassesOf, ResourceCost::Model::matchFunc, ResourceCost::Model::mapFunc) > 0.0);
+    REQUIRE(rm.usageOf(x) == 4.f);
+    REQUIRE(rm.usageOf(y) == 4.f);
+    REQUIRE(rm.consumersOf(Hyperedges{"Provider::X"}).size() == 2);
+    // The ledger has to agree with the graph
+    REQUIRE(ResourceCost::Model(static_cast<const Hypergraph&>(rm)).usageOf(x) == 4.f);
+}
+
 TEST_CASE("Perform a real world exemplary mapping of software to hardware components", "[SWHWMapping]")
 {
     // Setup software model
@@ -117,16 +418,71 @@ TEST_CASE("Perform a real world exemplary mapping of software to hardware compon
     fout << YAML::StringFrom(sw2hw) << std::endl;
     fout.close();
 
+    // The reachability index has to agree with the topology: x - y - z
+    const Software::Hardware::Reachability reachability(sw2hw);
+    const UniqueId x(hw.processors("x")[0]);
+    const UniqueId y(hw.processors("y")[0]);
+    const UniqueId z(hw.processors("z")[0]);
+    REQUIRE(reachability.indexOf("Unknown::Uid") < 0);
+    REQUIRE(reachability.contains(reachability.adjacentComponentsOf(reachability.indexOf(y)), x));
+    REQUIRE(reachability.contains(reachability.adjacentComponentsOf(reachability.indexOf(y)), z));
+    REQUIRE(!reachability.contains(reachability.adjacentComponentsOf(reachability.indexOf(x)), z));
+    for (const UniqueId& interfaceUid : hw.interfacesOf(Hyperedges{y}))
+    {
+        REQUIRE(reachability.uidsOf(reachability.ownersOf(reachability.indexOf(interfaceUid))) == Hyperedges{y});
+        REQUIRE(reachability.adjacentInterfacesOf(reachability.indexOf(interfaceUid)).size() == 1);
+    }
+    // a -> b -> c -> a
+    REQUIRE(reachability.adjacentComponentsOf(reachability.indexOf(sw.components("a")[0])).size() == 2);
+    // Routing: x and z are two hops apart
+    REQUIRE(reachability.hopsBetween(reachability.indexOf(x), reachability.indexOf(z)) == 2);
+    REQUIRE(reachability.hopsBetween(reachability.indexOf(y), reachability.indexOf(y)) == 0);
+    REQUIRE(!reachability.reachable(x, z));
+    REQUIRE(Software::Hardware::Reachability(sw2hw, 2).reachable(x, z));
+
     // Start the mapping
     Software::Hardware::Mapper mapper(sw2hw);
     const float globalCosts(mapper.map());
-    REQUIRE(globalCosts >= 0.f);
+    // Two neighbouring processors are filled up and the third one is left (the interfaces add no costs)
+    REQUIRE(mapper.globalCosts() == Approx(1.f / 3.f));
+    REQUIRE(globalCosts == Approx(mapper.globalCosts() / 2.f));
     // Check mapping
     // Every implementation needs a processor to execute
     for (const UniqueId& consumerUid : sw.implementations())
     {
         REQUIRE(mapper.providersOf(Hyperedges{consumerUid}).size() == 1);
     }
+    // An optimal assignment has to map every implementation as well (with and without the costs between the implementations of the loop)
+    for (const double weight : {1.0, 0.0})
+    {
+        Software::Hardware::Mapper optimalMapper(sw2hw);
+        optimalMapper.communicationWeight(weight);
+        REQUIRE(optimalMapper.map(ResourceCost::AssignmentSolver()) == Approx(globalCosts));
+        for (const UniqueId& consumerUid : sw.implementations())
+        {
+            REQUIRE(optimalMapper.providersOf(Hyperedges{consumerUid}).size() == 1);
+        }
+    }
+    // Branch and bound has to find a complete mapping which is at least as good as the greedy one
+    Software::Hardware::Mapper exactMapper(sw2hw);
+    REQUIRE(exactMapper.mapAllImplementationsToProcessors(ResourceCost::BranchAndBoundSolver(10.0, Software::Hardware::Mapper::equivalentProcessors)) >= Software::Hardware::Mapper(sw2hw).mapAllImplementationsToProcessors());
+    // Improving the mapping keeps every implementation mapped and re-maps the interfaces
+    Software::Hardware::Mapper improvedMapper(sw2hw);
+    REQUIRE(improvedMapper.map() == Approx(globalCosts));
+    REQUIRE(improvedMapper.improve(ResourceCost::AnnealingSolver(1, 500)) == Approx(1.f / 3.f));
+    for (const UniqueId& consumerUid : sw.implementations())
+    {
+        REQUIRE(improvedMapper.providersOf(Hyperedges{consumerUid}).size() == 1);
+    }
+    REQUIRE(improvedMapper.providersOf(sw.interfacesOf(sw.implementations())).size() == mapper.providersOf(sw.interfacesOf(sw.implementations())).size());
+    // Precomputing with several threads must not change the result
+    Software::Hardware::Mapper parallelMapper(sw2hw);
+    parallelMapper.threads(4);
+    REQUIRE(parallelMapper.map() == globalCosts);
+    for (const UniqueId& consumerUid : sw.implementations())
+    {
+        REQUIRE(parallelMapper.providersOf(Hyperedges{consumerUid}) == mapper.providersOf(Hyperedges{consumerUid}));
+    }
 
     // Store for potential later user
     fout.open("rcm_spec.yml");
@@ -135,3 +491,542 @@ TEST_CASE("Perform a real world exemplary mapping of software to hardware compon
     fout.close();
 }
 
+TEST_CASE("Route between processors which are not directly connected", "[Routing]")
+{
+    // Two communicating implementations which do not fit onto the same processor
+    Software::Network sw;
+    sw.createImplementation("Implementation::A", "Implementation A");
+    sw.createImplementationInterface("Implementation::Interface::X", "Interface X");
+    sw.needsInterface(Hyperedges{"Implementation::A"}, sw.instantiateFrom(Hyperedges{"Implementation::Interface::X"}, "in"));
+    sw.providesInterface(Hyperedges{"Implementation::A"}, sw.instantiateFrom(Hyperedges{"Implementation::Interface::X"}, "out"));
+    sw.instantiateComponent(Hyperedges{"Implementation::A"}, "a");
+    sw.instantiateComponent(Hyperedges{"Implementation::A"}, "b");
+    sw.dependsOn(sw.interfacesOf(sw.components("b"), "in"), sw.interfacesOf(sw.components("a"), "out"));
+
+    // Two processors connected by a switch: p - s - q
+    Hardware::Computational::Network hw(sw);
+    hw.createProcessor("Processor::P", "P");
+    hw.instantiateInterfaceFor(Hyperedges{"Processor::P"}, Hyperedges{Hardware::Computational::Network::InterfaceId}, "eth0");
+    hw.createDevice("Device::Switch", "Switch");
+    hw.instantiateInterfaceFor(Hyperedges{"Device::Switch"}, Hyperedges{Hardware::Computational::Network::InterfaceId}, "port0");
+    hw.instantiateInterfaceFor(Hyperedges{"Device::Switch"}, Hyperedges{Hardware::Computational::Network::InterfaceId}, "port1");
+    hw.instantiateComponent(Hyperedges{"Processor::P"}, "p");
+    hw.instantiateComponent(Hyperedges{"Processor::P"}, "q");
+    hw.instantiateComponent(Hyperedges{"Device::Switch"}, "s");
+    hw.connectInterface(hw.interfacesOf(hw.processors("p"), "eth0"), hw.interfacesOf(hw.devices("s"), "port0"));
+    hw.connectInterface(hw.interfacesOf(hw.processors("q"), "eth0"), hw.interfacesOf(hw.devices("s"), "port1"));
+
+    ResourceCost::Model sw2hw(hw);
+    sw2hw.isConsumer(Hyperedges{"Implementation::A", "Implementation::Interface::X"});
+    sw2hw.isProvider(Hyperedges{"Processor::P", Hardware::Computational::Network::InterfaceId});
+    sw2hw.defineResource("Resource::Memory", "Memory");
+    sw2hw.provides(sw2hw.concepts("p"), sw2hw.instantiateResource(sw2hw.concepts("Memory"), 64.f));
+    sw2hw.provides(sw2hw.concepts("q"), sw2hw.instantiateResource(sw2hw.concepts("Memory"), 64.f));
+    sw2hw.consumes(sw2hw.concepts("a"), sw2hw.instantiateResource(sw2hw.concepts("Memory"), 40.f));
+    sw2hw.consumes(sw2hw.concepts("b"), sw2hw.instantiateResource(sw2hw.concepts("Memory"), 40.f));
+
+    // The switch is two hops away from each processor
+    const Software::Hardware::Reachability reachability(sw2hw, 2);
+    const UniqueId p(hw.processors("p")[0]);
+    const UniqueId q(hw.processors("q")[0]);
+    REQUIRE(reachability.hopsBetween(reachability.indexOf(p), reachability.indexOf(q)) == 2);
+    REQUIRE(reachability.reachable(p, q));
+    REQUIRE(reachability.reachableVia(hw.interfacesOf(Hyperedges{p})[0], hw.interfacesOf(Hyperedges{q})[0]));
+
+    // With direct connections only, b cannot be mapped
+    Software::Hardware::Mapper direct(sw2hw);
+    REQUIRE(direct.mapAllImplementationsToProcessors() < 0.f);
+    // With two hops, the implementations and their interfaces can be mapped through the switch
+    Software::Hardware::Mapper routed(sw2hw);
+    routed.maxHops(2);
+    REQUIRE(routed.map() == Approx(0.375f / 2.f));
+    REQUIRE(routed.providersOf(sw.components("a")).size() == 1);
+    REQUIRE(routed.providersOf(sw.components("b")).size() == 1);
+    REQUIRE(routed.providersOf(sw.components("a")) != routed.providersOf(sw.components("b")));
+    REQUIRE(routed.providersOf(sw.interfacesOf(sw.components("a"), "out")).size() == 1);
+    REQUIRE(routed.providersOf(sw.interfacesOf(sw.components("b"), "in")).size() == 1);
+
+    // Outside of a mapping run, the match function respects the hop limit of the mapper as well
+    Software::Hardware::Mapper partial(sw2hw);
+    partial.maxHops(2);
+    Software::Hardware::Mapper::mapImplementationToProcessor(partial, sw.components("a")[0], p);
+    REQUIRE(Software::Hardware::Mapper::matchImplementationAndProcessor(partial, sw.components("b")[0], q) >= 0.f);
+    partial.maxHops(1);
+    REQUIRE(Software::Hardware::Mapper::matchImplementationAndProcessor(partial, sw.components("b")[0], q) < 0.f);
+
+    // The threads of a solver use the index of the run they work for, even if several runs are active
+    std::vector< Software::Hardware::Mapper > runs(4, Software::Hardware::Mapper(sw2hw));
+    std::vector< float > results(runs.size(), -1.f);
+    std::vector< std::thread > pool;
+    for (std::size_t i = 0; i < runs.size(); ++i)
+    {
+        pool.push_back(std::thread([&, i] () {
+            runs[i].maxHops(2);
+            runs[i].threads(4);
+            results[i] = runs[i].map(ResourceCost::MultiStartSolver(8, i));
+        }));
+    }
+    for (std::thread& t : pool)
+        t.join();
+    for (std::size_t i = 0; i < runs.size(); ++i)
+    {
+        REQUIRE(results[i] == Approx(0.375f / 2.f));
+        REQUIRE(runs[i].providersOf(sw.components("a")) != runs[i].providersOf(sw.components("b")));
+    }
+}
+
+static ResourceCost::Model memoryModel(const std::vector< std::pair< std::string, float > >& demands, const std::vector< std::pair< std::string, std::string > >& dependencies, const std::vector< std::pair< std::string, std::vector< std::string > > >& boards, const std::vector< std::pair< std::string, std::string > >& links, const float capacity=64.f)
+{
+    // Implementations of one type which consume the given amounts of memory and feed each other (the first of a dependency feeds the second)
+    Software::Network sw;
+    sw.createImplementation("Implementation::A", "Implementation A");
+    sw.createImplementationInterface("Implementation::Interface::X", "Interface X");
+    sw.needsInterface(Hyperedges{"Implementation::A"}, sw.instantiateFrom(Hyperedges{"Implementation::Interface::X"}, "in"));
+    sw.providesInterface(Hyperedges{"Implementation::A"}, sw.instantiateFrom(Hyperedges{"Implementation::Interface::X"}, "out"));
+    for (const std::pair< std::string, float >& demand : demands)
+        sw.instantiateComponent(Hyperedges{"Implementation::A"}, demand.first);
+    for (const std::pair< std::string, std::string >& dependency : dependencies)
+        sw.dependsOn(sw.interfacesOf(sw.components(dependency.second), "in"), sw.interfacesOf(sw.components(dependency.first), "out"));
+
+    // Processors of one type which are part of the given boards (unless the name of the board is empty) and linked by their only interfaces
+    Hardware::Computational::Network hw(sw);
+    hw.createDevice("Device::Board", "Board");
+    hw.createProcessor("Processor::P", "P");
+    hw.instantiateInterfaceFor(Hyperedges{"Processor::P"}, Hyperedges{Hardware::Computational::Network::InterfaceId}, "can0");
+    for (const std::pair< std::string, std::vector< std::string > >& board : boards)
+    {
+        Hyperedges procUids;
+        for (const std::string& name : board.second)
+            procUids = unite(procUids, hw.instantiateComponent(Hyperedges{"Processor::P"}, name));
+        if (board.first.empty())
+            continue;
+        hw.partOfComponent(procUids, hw.instantiateComponent(Hyperedges{"Device::Board"}, board.first));
+    }
+    for (const std::pair< std::string, std::string >& link : links)
+        hw.connectInterface(hw.interfacesOf(hw.processors(link.first), "can0"), hw.interfacesOf(hw.processors(link.second), "can0"));
+
+    ResourceCost::Model sw2hw(hw);
+    sw2hw.isConsumer(Hyperedges{"Implementation::A", "Implementation::Interface::X"});
+    sw2hw.isProvider(Hyperedges{"Processor::P", Hardware::Computational::Network::InterfaceId});
+    sw2hw.defineResource("Resource::Memory", "Memory");
+    for (const UniqueId& procUid : hw.processors())
+        sw2hw.provides(Hyperedges{procUid}, sw2hw.instantiateResource(sw2hw.concepts("Memory"), capacity));
+    for (const std::pair< std::string, float >& demand : demands)
+        sw2hw.consumes(sw2hw.concepts(demand.first), sw2hw.instantiateResource(sw2hw.concepts("Memory"), demand.second));
+    return sw2hw;
+}
+
+static ResourceCost::Model fanOutModel(const float linkCapacity)
+{
+    // a feeds b and c, but they cannot share a processor with a, and the two processors are linked by their only interfaces
+    ResourceCost::Model sw2hw(memoryModel({{"a", 48.f}, {"b", 24.f}, {"c", 24.f}}, {{"a", "b"}, {"a", "c"}}, {{"", {"p", "q"}}}, {{"p", "q"}}));
+    const Software::NetworkView sw(sw2hw);
+    const Hardware::Computational::NetworkView hw(sw2hw);
+    sw2hw.defineResource(Software::Hardware::Mapper::DataRateUid, "DataRate");
+    // Every flow needs 6 units, so each one fits through the link, but not necessarily both
+    for (const std::string& name : {"a", "b", "c"})
+    {
+        const std::string& direction(name == "a" ? "out" : "in");
+        sw2hw.needs(sw.interfacesOf(sw.components(name), direction), sw2hw.instantiateResource(Hyperedges{Software::Hardware::Mapper::DataRateUid}, 6.f));
+    }
+    sw2hw.provides(hw.interfacesOf(hw.processors()), sw2hw.instantiateResource(Hyperedges{Software::Hardware::Mapper::DataRateUid}, linkCapacity));
+    return sw2hw;
+}
+
+TEST_CASE("Respect the capacities of hw links when mapping interfaces", "[Bandwidth]")
+{
+    // Both flows share the link between p and q (a occupies one processor, b and c the other one)
+    Software::Hardware::Mapper wide(fanOutModel(12.f));
+    REQUIRE(wide.map() == Approx(0.25f / 2.f));
+    const Software::NetworkView sw(wide);
+    const Hardware::Computational::NetworkView hw(wide);
+    const Hyperedges& inputUids(sw.interfacesOf(unite(sw.components("b"), sw.components("c")), "in"));
+    REQUIRE(inputUids.size() == 2);
+    REQUIRE(wide.providersOf(Hyperedges{inputUids[0]}).size() == 1);
+    REQUIRE(wide.providersOf(Hyperedges{inputUids[1]}).size() == 1);
+    const Hyperedges& linkUids(hw.interfacesOf(hw.processors()));
+    REQUIRE(linkUids.size() == 2);
+    REQUIRE(wide.linkLoadOf(linkUids[0], linkUids[1]) == 12.f);
+
+    // A narrower link can only carry one of them
+    Software::Hardware::Mapper narrow(fanOutModel(10.f));
+    REQUIRE(narrow.map() == Approx(0.25f / 2.f));
+    REQUIRE(narrow.providersOf(inputUids).size() == 1);
+    REQUIRE(narrow.linkLoadOf(linkUids[0], linkUids[1]) == 6.f);
+}
+
+static ResourceCost::Model pairModel()
+{
+    // a feeds b and both fit onto one of two linked processors
+    return memoryModel({{"a", 16.f}, {"b", 16.f}}, {{"a", "b"}}, {{"", {"p", "q"}}}, {{"p", "q"}});
+}
+
+TEST_CASE("Keep communicating implementations close to each other", "[Communication]")
+{
+    const ResourceCost::Model& sw2hw(pairModel());
+    const UniqueId a(sw2hw.concepts("a")[0]);
+    const UniqueId b(sw2hw.concepts("b")[0]);
+
+    // One connection without a data rate
+    const Software::Hardware::Reachability reachability(sw2hw);
+    const Software::Hardware::CommunicationObjective communication(sw2hw, reachability);
+    REQUIRE(communication.trafficBetween(a, b) == 1.0);
+    REQUIRE(communication.totalTraffic() == 1.0);
+    REQUIRE(communication.neighboursOf(a) == Hyperedges{b});
+
+    // Ignoring communication, the resources are balanced and all traffic travels one hop
+    Software::Hardware::Mapper balanced(sw2hw);
+    balanced.communicationWeight(0.0);
+    REQUIRE(balanced.map() == Approx(0.375f));
+    REQUIRE(balanced.globalCosts() == Approx(0.75f));
+    REQUIRE(balanced.providersOf(Hyperedges{a}) != balanced.providersOf(Hyperedges{b}));
+    REQUIRE(balanced.communicationCosts() == Approx(1.f));
+    REQUIRE(balanced.objective() == Approx(balanced.globalCosts()));
+
+    // Otherwise, every strategy puts both onto the same processor
+    // NOTE: The assignment prices the costs between a and b by the providers of the round before
+    const ResourceCost::Solver greedy;
+    const ResourceCost::AssignmentSolver mincostflow;
+    const ResourceCost::BranchAndBoundSolver branchandbound(10.0, Software::Hardware::Mapper::equivalentProcessors);
+    const ResourceCost::AnnealingSolver annealing(1, 2000);
+    const ResourceCost::MultiStartSolver multistart(6, 3);
+    const std::vector< const ResourceCost::Solver* > solvers{&greedy, &mincostflow, &branchandbound, &annealing, &multistart};
+    for (const ResourceCost::Solver* solver : solvers)
+    {
+        Software::Hardware::Mapper mapper(sw2hw);
+        // The residuals are the same as in the balanced mapping
+        REQUIRE(mapper.map(*solver) == Approx(0.375f));
+        REQUIRE(mapper.providersOf(Hyperedges{a}).size() == 1);
+        REQUIRE(mapper.providersOf(Hyperedges{a}) == mapper.providersOf(Hyperedges{b}));
+        REQUIRE(mapper.communicationCosts() == 0.f);
+        REQUIRE(mapper.objective() == Approx(mapper.globalCosts()));
+        REQUIRE(mapper.objective() > balanced.globalCosts() - balanced.communicationCosts());
+    }
+
+    // Annealing moves them together as well
+    Software::Hardware::Mapper spread(sw2hw);
+    spread.communicationWeight(0.0);
+    REQUIRE(spread.map() == Approx(0.375f));
+    spread.communicationWeight(1.0);
+    spread.improve(annealing);
+    REQUIRE(spread.providersOf(Hyperedges{a}) == spread.providersOf(Hyperedges{b}));
+}
+
+TEST_CASE("Map several models concurrently", "[Concurrency]")
+{
+    // Every thread runs its own mapping (e.g. of implementation variants), so they must not share their reachability index
+    const ResourceCost::Model& pair(pairModel());
+    const ResourceCost::Model& fanOut(fanOutModel(12.f));
+    std::vector< Software::Hardware::Mapper > mappers;
+    for (std::size_t i = 0; i < 4; ++i)
+        mappers.push_back(Software::Hardware::Mapper((i % 2) ? fanOut : pair));
+    std::vector< float > results(mappers.size(), -1.f);
+    std::vector< std::thread > pool;
+    for (std::size_t i = 0; i < mappers.size(); ++i)
+        pool.push_back(std::thread([&, i] () { results[i] = mappers[i].map(); }));
+    for (std::thread& t : pool)
+        t.join();
+
+    for (std::size_t i = 0; i < mappers.size(); ++i)
+    {
+        Software::Hardware::Mapper sequential((i % 2) ? fanOut : pair);
+        REQUIRE(results[i] == Approx((i % 2) ? 0.125f : 0.375f));
+        REQUIRE(sequential.map() == results[i]);
+        const Software::NetworkView sw(sequential);
+        for (const UniqueId& swUid : unite(sw.implementations(), sw.interfacesOf(sw.implementations())))
+            REQUIRE(mappers[i].providersOf(Hyperedges{swUid}) == sequential.providersOf(Hyperedges{swUid}));
+    }
+}
+
+TEST_CASE("Reuse mapping results by canonical hashes", "[MappingCache]")
+{
+    const ResourceCost::Model& sw2hw(pairModel());
+    const UniqueId a(sw2hw.concepts("a")[0]);
+    const UniqueId b(sw2hw.concepts("b")[0]);
+    const ResourceCost::Solver greedy;
+
+    // The hash only depends on the content, not on its representation
+    Software::Hardware::Mapper mapper(sw2hw);
+    const std::string key(mapper.canonicalHash(greedy.name()));
+    const Software::Hardware::Mapper reloaded(ResourceCost::Model(YAML::Load(YAML::StringFrom(sw2hw)).as<Hypergraph>()));
+    REQUIRE(reloaded.canonicalHash(greedy.name()) == key);
+    REQUIRE(mapper.canonicalHash("other") != key);
+
+    // A changed demand only changes the hash of its implementation
+    ResourceCost::Model changedModel(sw2hw);
+    changedModel.consumes(changedModel.concepts("b"), changedModel.instantiateResource(changedModel.concepts("Memory"), 8.f));
+    Software::Hardware::Mapper changed(changedModel);
+    const std::string changedKey(changed.canonicalHash(greedy.name()));
+    REQUIRE(changedKey != key);
+    REQUIRE(changed.hardwareHash() == mapper.hardwareHash());
+    REQUIRE(changed.implementationHashes()[a] == mapper.implementationHashes()[a]);
+    REQUIRE(changed.implementationHashes()[b] != mapper.implementationHashes()[b]);
+
+    // Start with an empty cache in a directory of its own
+    char dirTemplate[] = "/tmp/mapping_cache_XXXXXX";
+    REQUIRE(mkdtemp(dirTemplate));
+    const std::string dirName(dirTemplate);
+    const Software::Hardware::MappingCache cache(dirName);
+    const float fresh(mapper.map(greedy, cache));
+    REQUIRE(fresh == Approx(0.375f));
+    Software::Hardware::MappingCache::Entry entry;
+    REQUIRE(cache.find(mapper.hardwareHash(), key, entry));
+    REQUIRE(entry.executedOn.size() == 2);
+
+    // An unchanged input is restored
+    Software::Hardware::Mapper restored(sw2hw);
+    REQUIRE(restored.map(greedy, cache) == fresh);
+    REQUIRE(restored.globalCosts() == Approx(mapper.globalCosts()));
+    const Software::NetworkView sw(mapper);
+    for (const UniqueId& swUid : unite(sw.implementations(), sw.interfacesOf(sw.implementations())))
+        REQUIRE(restored.providersOf(Hyperedges{swUid}) == mapper.providersOf(Hyperedges{swUid}));
+
+    // A changed input keeps the processor of the unchanged implementation
+    REQUIRE(changed.map(greedy, cache) == Approx(0.34375f));
+    REQUIRE(changed.providersOf(Hyperedges{a}) == mapper.providersOf(Hyperedges{a}));
+    REQUIRE(changed.providersOf(Hyperedges{b}).size() == 1);
+    REQUIRE(cache.find(changed.hardwareHash(), changedKey, entry));
+    // The entries of the same hardware share a subdirectory (and there is nothing else in the cache)
+    const std::string hardwareDirName(dirName + "/" + mapper.hardwareHash());
+    REQUIRE(std::remove((hardwareDirName + "/" + key + ".cache").c_str()) == 0);
+    REQUIRE(std::remove((hardwareDirName + "/" + changedKey + ".cache").c_str()) == 0);
+    REQUIRE(rmdir(hardwareDirName.c_str()) == 0);
+    REQUIRE(rmdir(dirName.c_str()) == 0);
+}
+
+TEST_CASE("Map along the hierarchy of devices", "[Hierarchy]")
+{
+    // a feeds b and c feeds d, but every processor hosts only one of them, and there are two boards of two linked processors each
+    const ResourceCost::Model& sw2hw(memoryModel({{"a", 40.f}, {"b", 40.f}, {"c", 40.f}, {"d", 40.f}}, {{"a", "b"}, {"c", "d"}}, {{"x", {"x0", "x1"}}, {"y", {"y0", "y1"}}}, {{"x0", "x1"}, {"y0", "y1"}}));
+    const Software::NetworkView sw(sw2hw);
+
+    // Both pairs stay on their boards and their connections can be mapped
+    Software::Hardware::Mapper mapper(sw2hw);
+    mapper.threads(2);
+    REQUIRE(mapper.mapHierarchically() == Approx(0.1875f));
+    REQUIRE(mapper.globalCosts() == Approx(0.375f));
+    REQUIRE(mapper.communicationCosts() == Approx(1.f));
+    const Hardware::Computational::NetworkView view(mapper);
+    for (const std::string& board : {"x", "y"})
+        REQUIRE(mapper.consumersOf(view.subcomponentsOf(view.devices(board))).size() == 2);
+    for (const std::pair< std::string, std::string >& pair : {std::make_pair("a", "b"), std::make_pair("c", "d")})
+    {
+        const Hyperedges& procUids(unite(mapper.providersOf(mapper.concepts(pair.first)), mapper.providersOf(mapper.concepts(pair.second))));
+        REQUIRE(procUids.size() == 2);
+        REQUIRE(view.subcomponentsOf(procUids, "", Hypergraph::TraversalDirection::FORWARD).size() == 1);
+    }
+    for (const UniqueId& swUid : unite(sw.interfacesOf(sw.components("a"), "out"), sw.interfacesOf(sw.components("b"), "in")))
+        REQUIRE(mapper.providersOf(Hyperedges{swUid}).size() == 1);
+
+    // Ignoring communication, the consumers still have to be placed where their producers can be reached (the boards are not linked)
+    Software::Hardware::Mapper spread(sw2hw);
+    spread.communicationWeight(0.0);
+    REQUIRE(spread.mapHierarchically() == Approx(0.1875f));
+    REQUIRE(spread.globalCosts() == Approx(0.375f));
+    // ... so every pair is assigned to a board as a whole
+    for (const std::string& board : {"x", "y"})
+        REQUIRE(spread.consumersOf(view.subcomponentsOf(view.devices(board))).size() == 2);
+    const Software::Hardware::Reachability reachability(spread);
+    for (const std::pair< std::string, std::string >& pair : {std::make_pair("a", "b"), std::make_pair("c", "d")})
+    {
+        const Hyperedges& fromUids(spread.providersOf(spread.concepts(pair.first)));
+        const Hyperedges& toUids(spread.providersOf(spread.concepts(pair.second)));
+        REQUIRE(fromUids.size() == 1);
+        REQUIRE(toUids.size() == 1);
+        REQUIRE(reachability.reachable(fromUids[0], toUids[0]));
+        for (const UniqueId& swUid : unite(sw.interfacesOf(sw.components(pair.first), "out"), sw.interfacesOf(sw.components(pair.second), "in")))
+            REQUIRE(spread.providersOf(Hyperedges{swUid}).size() == 1);
+    }
+
+    // Without any hierarchy, it is the same as map()
+    Software::Hardware::Mapper flat(pairModel());
+    Software::Hardware::Mapper hierarchical(flat);
+    REQUIRE(hierarchical.mapHierarchically() == Approx(0.375f));
+    REQUIRE(flat.map() == Approx(0.375f));
+    REQUIRE(hierarchical.globalCosts() == Approx(flat.globalCosts()));
+    const Software::NetworkView pairView(flat);
+    for (const UniqueId& swUid : unite(pairView.implementations(), pairView.interfacesOf(pairView.implementations())))
+        REQUIRE(hierarchical.providersOf(Hyperedges{swUid}) == flat.providersOf(Hyperedges{swUid}));
+}
+
+TEST_CASE("Map independent parts of the networks separately", "[Decomposition]")
+{
+    // Two pipelines (a feeds b, c feeds d) and e on its own, two linked processors (p, q) and a separate one (r)
+    const ResourceCost::Model& sw2hw(memoryModel({{"a", 16.f}, {"b", 16.f}, {"c", 16.f}, {"d", 16.f}, {"e", 48.f}}, {{"a", "b"}, {"c", "d"}}, {{"", {"p", "q", "r"}}}, {{"p", "q"}}));
+
+    // Every pipeline stays within the processors it can communicate over
+    Software::Hardware::Mapper mapper(sw2hw);
+    mapper.threads(2);
+    // p and q host e and one pipeline, whose reserved shares leave no room for e, so e is mapped by the final pass
+    REQUIRE(mapper.mapDecomposed() == Approx(1.25f / 3.f / 2.f));
+    REQUIRE(mapper.globalCosts() == Approx(1.25f / 3.f));
+    const Software::Hardware::Reachability reachability(mapper);
+    for (const std::pair< std::string, std::string >& pair : {std::make_pair("a", "b"), std::make_pair("c", "d")})
+    {
+        const Hyperedges& fromUids(mapper.providersOf(mapper.concepts(pair.first)));
+        const Hyperedges& toUids(mapper.providersOf(mapper.concepts(pair.second)));
+        REQUIRE(fromUids.size() == 1);
+        REQUIRE(toUids.size() == 1);
+        REQUIRE(reachability.reachable(fromUids[0], toUids[0]));
+    }
+    REQUIRE(mapper.providersOf(mapper.concepts("e")).size() == 1);
+}
+
+TEST_CASE("Trade off load, communication and powered processors", "[Pareto]")
+{
+    const ResourceCost::Model& sw2hw(pairModel());
+    const UniqueId a(sw2hw.concepts("a")[0]);
+    const UniqueId b(sw2hw.concepts("b")[0]);
+
+    // Either both share one processor (no communication) or they are spread (balanced)
+    const Software::Hardware::Mapper mapper(sw2hw);
+    Software::Hardware::Mapper parallel(sw2hw);
+    parallel.threads(4);
+    const std::vector< Software::Hardware::Mapper >& front(mapper.paretoFront());
+    REQUIRE(front.size() == 2);
+    REQUIRE(front[0].poweredProcessors() == 1);
+    REQUIRE(front[0].communicationCosts() == 0.f);
+    REQUIRE(front[0].bottleneckSlack() == Approx(0.5f));
+    REQUIRE(front[1].poweredProcessors() == 2);
+    REQUIRE(front[1].communicationCosts() == Approx(1.f));
+    REQUIRE(front[1].bottleneckSlack() == Approx(0.75f));
+    REQUIRE(front[1].providersOf(Hyperedges{a}) != front[1].providersOf(Hyperedges{b}));
+
+    // Neither the mapper nor the result depend on the threads
+    REQUIRE(Software::Hardware::Mapper::unmappedImplementations(mapper).size() == 2);
+    const std::vector< Software::Hardware::Mapper >& parallelFront(parallel.paretoFront());
+    REQUIRE(parallelFront.size() == front.size());
+    for (std::size_t i = 0; i < front.size(); ++i)
+    {
+        REQUIRE(parallelFront[i].providersOf(Hyperedges{a}) == front[i].providersOf(Hyperedges{a}));
+        REQUIRE(parallelFront[i].providersOf(Hyperedges{b}) == front[i].providersOf(Hyperedges{b}));
+    }
+}
+
+TEST_CASE("Only enumerate implementation networks which can fit on the hardware", "[Feasibility]")
+{
+    // Two instances of A, which has three implementations of different sizes
+    Software::Network sw;
+    sw.createAlgorithm("Algorithm::A", "A");
+    for (const std::string& impl : {"Implementation::A1", "Implementation::A2", "Implementation::A3"})
+    {
+        sw.createImplementation(impl, impl);
+        sw.implements(Hyperedges{impl}, Hyperedges{"Algorithm::A"});
+    }
+    sw.instantiateComponent(Hyperedges{"Algorithm::A"}, "1");
+    sw.instantiateComponent(Hyperedges{"Algorithm::A"}, "2");
+
+    // Two processors with 64 and 32 units of memory
+    Hardware::Computational::Network hw(sw);
+    hw.createProcessor("Processor::X", "X");
+    hw.instantiateComponent(Hyperedges{"Processor::X"}, "x");
+    hw.instantiateComponent(Hyperedges{"Processor::X"}, "y");
+    ResourceCost::Model sw2hw(hw);
+    sw2hw.isConsumer(Hyperedges{"Implementation::A1", "Implementation::A2", "Implementation::A3"});
+    sw2hw.isProvider(Hyperedges{"Processor::X"});
+    sw2hw.defineResource("Resource::Memory", "Memory");
+    sw2hw.provides(sw2hw.concepts("x"), sw2hw.instantiateResource(sw2hw.concepts("Memory"), 64.f));
+    sw2hw.provides(sw2hw.concepts("y"), sw2hw.instantiateResource(sw2hw.concepts("Memory"), 32.f));
+    // A1 only fits on x (so not twice), A2 fits everywhere and A3 nowhere
+    sw2hw.consumes(Hyperedges{"Implementation::A1"}, sw2hw.instantiateResource(sw2hw.concepts("Memory"), 60.f));
+    sw2hw.consumes(Hyperedges{"Implementation::A2"}, sw2hw.instantiateResource(sw2hw.concepts("Memory"), 16.f));
+    sw2hw.consumes(Hyperedges{"Implementation::A3"}, sw2hw.instantiateResource(sw2hw.concepts("Memory"), 100.f));
+    sw2hw.indexResources();
+
+    const Software::Hardware::FeasibleImplementationNetworks variants(sw, sw2hw, Hardware::Computational::Network(sw2hw));
+    REQUIRE(variants.size() == 9);
+    REQUIRE(variants.feasible().size() == 3);
+    // A3 is cut once per level (1 + 2) and A1 after A1 once
+    REQUIRE(variants.pruned() == 4);
+    std::vector< std::string > built;
+    variants.forEach([&] (const std::size_t, const Software::NetworkOverlay& overlay) {
+        std::string labels;
+        for (const UniqueId& implUid : overlay.implementations())
+            labels += overlay.access(overlay.instancesOf(Hyperedges{implUid}, "", Hypergraph::FORWARD)[0]).label();
+        built.push_back(labels);
+    }, 1, variants.feasible());
+    REQUIRE(built.size() == 3);
+    for (const std::string& labels : built)
+    {
+        REQUIRE(labels.find("A3") == std::string::npos);
+        REQUIRE(labels != "Implementation::A1Implementation::A1");
+    }
+
+    // Mapping an overlay is the same as mapping its flattened network
+    const Hardware::Computational::Network hwn(sw2hw);
+    for (const std::size_t i : variants.feasible())
+    {
+        Software::Hardware::Mapper fromOverlay(sw2hw, variants.overlayAt(i), hwn);
+        Software::Hardware::Mapper fromNetwork(sw2hw, variants.at(i), hwn);
+        REQUIRE(fromOverlay.map() == fromNetwork.map());
+        const Hyperedges& implUids(Software::Hardware::Mapper::implementations(fromOverlay));
+        REQUIRE(implUids.size() == 2);
+        REQUIRE(implUids == Software::Hardware::Mapper::implementations(fromNetwork));
+        for (const UniqueId& implUid : implUids)
+            REQUIRE(fromOverlay.providersOf(Hyperedges{implUid}) == fromNetwork.providersOf(Hyperedges{implUid}));
+    }
+}
+
+#ifndef DIAGNOSTICS_DISABLED
+TEST_CASE("Count rejections instead of printing them", "[Diagnostics]")
+{
+    // Restore the global diagnostics state even if a check fails
+    struct Restore
+    {
+        std::ostream& sink;
+        const Diagnostics::Level level;
+        const bool counting;
+        Restore() : sink(Diagnostics::sink()), level(Diagnostics::level()), counting(Diagnostics::counting()) {}
+        ~Restore()
+        {
+            Diagnostics::reset();
+            Diagnostics::sink(sink);
+            Diagnostics::level(level);
+            Diagnostics::counting(counting);
+        }
+    } restore;
+    std::ostringstream messages;
+    Diagnostics::sink(messages);
+    Diagnostics::level(Diagnostics::INFO);
+    Diagnostics::counting(true);
+    Diagnostics::reset();
+
+    // a does not fit onto p
+    ResourceCost::Model rm;
+    rm.defineResource("Resource::Memory", "Memory");
+    rm.concept("Consumer::a", "a");
+    rm.concept("Provider::p", "p");
+    rm.isConsumer(Hyperedges{"Consumer::a"});
+    rm.isProvider(Hyperedges{"Provider::p"});
+    const UniqueId a("Consumer::a");
+    const UniqueId p("Provider::p");
+    rm.consumes(Hyperedges{a}, rm.instantiateResource(rm.concepts("Memory"), 8.f));
+    rm.provides(Hyperedges{p}, rm.instantiateResource(rm.concepts("Memory"), 4.f));
+
+    // At the default level (INFO), rejections are counted but not written
+    REQUIRE(rm.satisfies(Hyperedges{p}, Hyperedges{a}) < 0.f);
+    REQUIRE(Diagnostics::countOf(Diagnostics::SAT_INSUFFICIENT) == 1);
+    REQUIRE(messages.str().empty());
+
+    // ... unless the level is DEBUG
+    Diagnostics::level(Diagnostics::DEBUG);
+    REQUIRE(rm.satisfies(Hyperedges{p}, Hyperedges{a}) < 0.f);
+    REQUIRE(Diagnostics::countOf(Diagnostics::SAT_INSUFFICIENT) == 2);
+    REQUIRE(messages.str().find("SAT-CHECK FAILED") != std::string::npos);
+
+    // Nothing at all when silent and not counting
+    Diagnostics::level(Diagnostics::SILENT);
+    Diagnostics::counting(false);
+    messages.str("");
+    REQUIRE(rm.satisfies(Hyperedges{p}, Hyperedges{a}) < 0.f);
+    REQUIRE(Diagnostics::totalCount() == 2);
+    REQUIRE(messages.str().empty());
+
+    std::ostringstream histogram;
+    Diagnostics::summary(histogram);
+    REQUIRE(histogram.str().find("sat-insufficient") != std::string::npos);
+    std::ostringstream json;
+    Diagnostics::json(json);
+    REQUIRE(json.str().find("\"sat-insufficient\": 2") != std::string::npos);
+}
+#endif
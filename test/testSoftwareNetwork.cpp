@@ -2,6 +2,10 @@
 #include "catch.hpp"
 #include "SoftwareNetwork.hpp"
 
+#include <atomic>
+#include <chrono>
+#include <thread>
+
 TEST_CASE("Setup and operate on a software network", "[Software::Network]")
 {
     Software::Network swn;
@@ -29,4 +33,164 @@ TEST_CASE("Setup and operate on a software network", "[Software::Network]")
     // Additional checks
     REQUIRE(swn.algorithms().size() == 2);
     REQUIRE(swn.interfaces().size() == 6);
+    // Query the same network through a view (without copying it)
+    const Software::NetworkView view(swn);
+    REQUIRE(view.algorithms() == swn.algorithms());
+    REQUIRE(view.interfaces() == swn.interfaces());
+    REQUIRE(view.inputsOf(Hyperedges{"Algorithm A"}) == swn.inputsOf(Hyperedges{"Algorithm A"}));
+}
+
+// Returns the implementations of the algorithms 1, 2 and 3 (e.g. "A1 A2 B3")
+template< typename View > static std::string implementationsOf(const View& variant, const Software::Network& algorithms)
+{
+    std::string result;
+    for (const std::string& name : {"1", "2", "3"})
+    {
+        const std::string& label(variant.access(variant.instancesOf(variant.realizersOf(algorithms.algorithms(name)), "", Hypergraph::TraversalDirection::FORWARD)[0]).label());
+        result += (result.empty() ? "" : " ") + label.substr(15);
+    }
+    return result;
+}
+
+TEST_CASE("Enumerate the implementation networks of an algorithm network", "[Software::ImplementationNetworks]")
+{
+    // Two connected instances of A, which has two implementations, and one of B, which has three
+    Software::Network swn;
+    swn.createAlgorithm("Algorithm A", "A");
+    swn.createAlgorithm("Algorithm B", "B");
+    swn.createInterface("Interface X", "X");
+    swn.needsInterface(Hyperedges{"Algorithm A"}, swn.instantiateInterfaceFor(Hyperedges{"Algorithm A"}, Hyperedges{"Interface X"}, "in"));
+    swn.providesInterface(Hyperedges{"Algorithm A"}, swn.instantiateInterfaceFor(Hyperedges{"Algorithm A"}, Hyperedges{"Interface X"}, "out"));
+    swn.createImplementationInterface("Implementation Interface X", "X");
+    for (const std::string& impl : {"Implementation A1", "Implementation A2", "Implementation B1", "Implementation B2", "Implementation B3"})
+    {
+        swn.createImplementation(impl, impl);
+        swn.implements(Hyperedges{impl}, Hyperedges{(impl[15] == 'A') ? "Algorithm A" : "Algorithm B"});
+        swn.needsInterface(Hyperedges{impl}, swn.instantiateInterfaceFor(Hyperedges{impl}, Hyperedges{"Implementation Interface X"}, "in"));
+        swn.providesInterface(Hyperedges{impl}, swn.instantiateInterfaceFor(Hyperedges{impl}, Hyperedges{"Implementation Interface X"}, "out"));
+    }
+    swn.instantiateComponent(Hyperedges{"Algorithm A"}, "1");
+    swn.instantiateComponent(Hyperedges{"Algorithm A"}, "2");
+    swn.instantiateComponent(Hyperedges{"Algorithm B"}, "3");
+    swn.dependsOn(swn.inputsOf(swn.algorithms("2")), swn.outputsOf(swn.algorithms("1")));
+
+    Software::ImplementationNetworks variants(swn);
+    REQUIRE(variants.size() == 12);
+    // The last variant chooses the last implementation of every algorithm
+    const std::vector< std::size_t >& last(variants.choicesOf(11));
+    REQUIRE(last.size() == 3);
+    REQUIRE(last[0] + last[1] + last[2] == 1 + 1 + 2);
+    REQUIRE(variants.choicesOf(0) == std::vector< std::size_t >(3, 0));
+
+    // The cursor builds every variant once, the implementation of the first algorithm changes slowest
+    const std::vector< std::string > expected{
+        "A1 A1 B1", "A1 A1 B2", "A1 A1 B3", "A1 A2 B1", "A1 A2 B2", "A1 A2 B3",
+        "A2 A1 B1", "A2 A1 B2", "A2 A1 B3", "A2 A2 B1", "A2 A2 B2", "A2 A2 B3"};
+    Software::Network variant;
+    std::size_t n(0);
+    while (variants.next(variant))
+    {
+        REQUIRE(n < expected.size());
+        REQUIRE(variant.implementations().size() == 3);
+        // The implementations of 1 and 2 are wired like the algorithms
+        const Hyperedges& inputUids(variant.inputsOf(variant.realizersOf(swn.algorithms("2"))));
+        REQUIRE(variant.endpointsOf(inputUids) == variant.outputsOf(variant.realizersOf(swn.algorithms("1"))));
+        REQUIRE(implementationsOf(variant, swn) == expected[n]);
+        ++n;
+    }
+    REQUIRE(n == 12);
+    REQUIRE(!variants.next(variant));
+    variants.reset(11);
+    REQUIRE(variants.next(variant));
+    REQUIRE(variants.index() == 12);
+    const std::vector< Software::Network >& all(swn.generateAllImplementationNetworks());
+    REQUIRE(all.size() == 12);
+    for (std::size_t i = 0; i < all.size(); ++i)
+        REQUIRE(implementationsOf(all[i], swn) == expected[i]);
+
+    // Several workers build the same variants and the results are consumed in order
+    // NOTE: Even if the first variant takes long, two workers must not produce 8 variants ahead of the consumer
+    std::vector< std::size_t > indices;
+    std::vector< std::string > labels;
+    std::atomic< std::size_t > numConsumed(0);
+    std::atomic< std::size_t > maxLead(0);
+    variants.forEachInOrder(
+        [&] (const std::size_t index, const Software::NetworkOverlay& overlay) {
+            if (!index)
+                std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            const std::size_t lead(index - numConsumed.load());
+            for (std::size_t current(maxLead.load()); (lead > current) && !maxLead.compare_exchange_weak(current, lead); );
+            return implementationsOf(overlay, swn);
+        },
+        [&] (const std::size_t index, const std::string& label) {
+            indices.push_back(index);
+            labels.push_back(label);
+            ++numConsumed;
+        }, 2);
+    REQUIRE(labels.size() == 12);
+    REQUIRE(maxLead.load() < 8);
+    for (std::size_t i = 0; i < labels.size(); ++i)
+    {
+        REQUIRE(indices[i] == i);
+        REQUIRE(labels[i] == expected[i]);
+    }
+}
+
+TEST_CASE("Query implementation networks as overlays of the algorithm network", "[Software::NetworkOverlay]")
+{
+    // One instance of A, which has two implementations, connected to itself
+    Software::Network swn;
+    swn.createAlgorithm("Algorithm A", "A");
+    swn.createInterface("Interface X", "X");
+    swn.needsInterface(Hyperedges{"Algorithm A"}, swn.instantiateInterfaceFor(Hyperedges{"Algorithm A"}, Hyperedges{"Interface X"}, "in"));
+    swn.providesInterface(Hyperedges{"Algorithm A"}, swn.instantiateInterfaceFor(Hyperedges{"Algorithm A"}, Hyperedges{"Interface X"}, "out"));
+    swn.createImplementationInterface("Implementation Interface X", "X");
+    for (const std::string& impl : {"Implementation A1", "Implementation A2"})
+    {
+        swn.createImplementation(impl, impl);
+        swn.implements(Hyperedges{impl}, Hyperedges{"Algorithm A"});
+        swn.needsInterface(Hyperedges{impl}, swn.instantiateInterfaceFor(Hyperedges{impl}, Hyperedges{"Implementation Interface X"}, "in"));
+        swn.providesInterface(Hyperedges{impl}, swn.instantiateInterfaceFor(Hyperedges{impl}, Hyperedges{"Implementation Interface X"}, "out"));
+    }
+    swn.instantiateComponent(Hyperedges{"Algorithm A"}, "1");
+    swn.dependsOn(swn.inputsOf(swn.algorithms("1")), swn.outputsOf(swn.algorithms("1")));
+
+    Software::ImplementationNetworks variants(swn);
+    REQUIRE(variants.size() == 2);
+    const Software::NetworkOverlay& overlay(variants.overlayAt(1));
+    const Software::Network& flat(overlay.flatten());
+    // The overlay answers like its flattened network ...
+    REQUIRE(overlay.algorithms() == flat.algorithms());
+    REQUIRE(overlay.implementations().size() == 1);
+    REQUIRE(overlay.implementations() == flat.implementations());
+    REQUIRE(overlay.access(overlay.implementations()[0]).label() == "1");
+    REQUIRE(overlay.instancesOf(overlay.implementations(), "", Hypergraph::FORWARD) == Hyperedges{"Implementation A2"});
+    REQUIRE(overlay.realizersOf(swn.algorithms("1")) == flat.realizersOf(swn.algorithms("1")));
+    const Hyperedges& implUids(overlay.realizersOf(swn.algorithms("1")));
+    REQUIRE(overlay.interfacesOf(implUids).size() == 2);
+    REQUIRE(overlay.interfacesOf(implUids) == flat.interfacesOf(implUids));
+    REQUIRE(overlay.inputsOf(implUids) == flat.inputsOf(implUids));
+    REQUIRE(overlay.outputsOf(implUids, "out") == flat.outputsOf(implUids, "out"));
+    REQUIRE(overlay.interfacesOf(overlay.inputsOf(implUids), "", Hypergraph::INVERSE) == implUids);
+    REQUIRE(overlay.endpointsOf(overlay.inputsOf(implUids)) == overlay.outputsOf(implUids));
+    REQUIRE(overlay.endpointsOf(overlay.outputsOf(implUids), "", Hypergraph::INVERSE) == flat.endpointsOf(flat.outputsOf(implUids), "", Hypergraph::INVERSE));
+    // ... and the same variant always gets the same uids
+    REQUIRE(variants.at(1).implementations() == implUids);
+    // ... but only stores the delta
+    REQUIRE(overlay.deltaSize() < 16);
+    REQUIRE(overlay.base().implementations().empty());
+
+    // Removing the implementation (and its facts) leaves the algorithm network
+    Software::NetworkOverlay reduced(overlay);
+    reduced.remove(implUids);
+    REQUIRE(reduced.implementations().empty());
+    REQUIRE(reduced.realizersOf(swn.algorithms("1")).empty());
+    // ... including the interfaces cloned for it
+    REQUIRE(reduced.interfaces() == overlay.base().interfaces());
+    REQUIRE(reduced.deltaSize() == 0);
+    // Hidden individuals of the base vanish from the answers and the flattened network
+    reduced.remove(swn.algorithms("1"));
+    REQUIRE(reduced.algorithms().empty());
+    REQUIRE(reduced.flatten().algorithms().empty());
+    REQUIRE(swn.algorithms("1").size() == 1);
 }
@@ -1,10 +1,13 @@
 #include "SoftwareNetwork.hpp"
+#include "Mapper.hpp"
 #include "HypergraphYAML.hpp"
 
+#include <algorithm>
 #include <iostream>
 #include <fstream>
 #include <sstream>
 #include <cassert>
+#include <cstdlib>
 #include <getopt.h>
 
 /*
@@ -14,6 +17,8 @@
 
 static struct option long_options[] = {
     {"help", no_argument, 0, 'h'},
+    {"threads", required_argument, 0, 'j'},
+    {"feasible", required_argument, 0, 'f'},
     {0,0,0,0}
 };
 
@@ -23,9 +28,12 @@ void usage (const char *myName)
     std::cout << myName << " <sw_spec> <output_prefix>\n\n";
     std::cout << "Options:\n";
     std::cout << "--help\t" << "Show usage\n";
+    std::cout << "--threads <n>\t" << "Build (and serialize) the networks with n threads (default: 1)\n";
+    std::cout << "--feasible <rcm_spec>\t" << "Only build the networks whose implementations can fit on the processors of the given resource cost model\n";
     std::cout << "\nExample:\n";
     std::cout << myName << " algorithm_net.yml implementation_net\n";
     std::cout << "The prefix implementation_net will produce as many implementation_netX.yml files as there are possibilities\n";
+    std::cout << "The files are written in the order of X, regardless of the number of threads\n";
 }
 
 int main (int argc, char **argv)
@@ -34,10 +42,12 @@ int main (int argc, char **argv)
 
     // Parse command line
     int c;
+    unsigned int threads(1);
+    std::string fileNameRcm;
     while (1)
     {
         int option_index = 0;
-        c = getopt_long(argc, argv, "h", long_options, &option_index);
+        c = getopt_long(argc, argv, "hj:f:", long_options, &option_index);
         if (c == -1)
             break;
 
@@ -46,6 +56,12 @@ int main (int argc, char **argv)
             case 'h':
             case '?':
                 break;
+            case 'j':
+                threads = std::max(1, std::atoi(optarg));
+                break;
+            case 'f':
+                fileNameRcm = std::string(optarg);
+                break;
             default:
                 std::cout << "W00t?!\n";
                 return -1;
@@ -63,26 +79,38 @@ int main (int argc, char **argv)
     const std::string fileNameOutPrefix(argv[optind+1]);
     Software::Network sw(YAML::LoadFile(fileNameIn).as<Hypergraph>());
 
-    std::cout << "Searching for possible implementation nets ...\n";
-    std::vector< Software::Network > results(sw.generateAllImplementationNetworks());
-
-    // Now we have a list of all possible implementation graphs which can be build from algorithm graphs
-    std::cout << "Found " << results.size() << " possible networks.\n";
-
-    std::cout << "Storing results\n";
-    std::ofstream fout;
-    int i = 0;
-    for (const Software::Network& current : results)
-    {
-        fout.open(fileNameOutPrefix+std::to_string(i)+".yml");
+    // Every possible implementation graph is built (and serialized) from the algorithm graph by the workers and stored in the order of the indices
+    auto produce = [] (const std::size_t, const Software::NetworkOverlay& variant) {
+        return YAML::StringFrom(variant.flatten());
+    };
+    auto consume = [&] (const std::size_t i, const std::string& yaml) {
+        std::ofstream fout(fileNameOutPrefix+std::to_string(i)+".yml");
         if(fout.good()) {
-            fout << YAML::StringFrom(current) << std::endl;
+            fout << yaml << std::endl;
         } else {
             std::cout << "FAILED\n";
         }
-        fout.close();
-        i++;
+    };
+
+    std::cout << "Searching for possible implementation nets ...\n";
+    if (!fileNameRcm.empty())
+    {
+        // Only the implementation graphs which can fit on the hardware are built at all
+        const ResourceCost::Model rcm(YAML::LoadFile(fileNameRcm).as<Hypergraph>());
+        const Hardware::Computational::Network hw(rcm);
+        const Software::Hardware::FeasibleImplementationNetworks variants(sw, rcm, hw);
+        std::cout << "Found " << variants.feasible().size() << " feasible of " << variants.size() << " possible networks.\n";
+
+        std::cout << "Storing results\n";
+        variants.forEachInOrder(produce, consume, threads, variants.feasible());
+        return variants.feasible().size();
     }
 
-    return results.size();
+    Software::ImplementationNetworks variants(sw);
+    std::cout << "Found " << variants.size() << " possible networks.\n";
+
+    std::cout << "Storing results\n";
+    variants.forEachInOrder(produce, consume, threads);
+
+    return variants.size();
 }
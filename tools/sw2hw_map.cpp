@@ -1,7 +1,9 @@
 #include "SoftwareNetwork.hpp"
 #include "HardwareComputationalNetwork.hpp"
 #include "ResourceCostModel.hpp"
+#include "ResourceCostSolver.hpp"
 #include "HypergraphYAML.hpp"
+#include "Diagnostics.hpp"
 
 #include "Mapper.hpp"
 
@@ -9,14 +11,45 @@
 #include <fstream>
 #include <sstream>
 #include <cassert>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
 #include <getopt.h>
+#include <dirent.h>
 
 /*
     This program maps a network of IMPLEMENTATION INSTANCES to a network of PROCESSOR INSTANCES
+
+    In batch mode (--variants), every network of a directory (e.g. generated by gen_impl_networks) is mapped together with the same rcm_spec.
+    The rcm_spec is loaded once and the variants are mapped concurrently. They are ranked by the objective of the Mapper.
+    Only the best variants are written (to <output_prefix><variant file name>) as well as a summary of all of them (to <output_prefix>summary.csv).
 */
 
 static struct option long_options[] = {
     {"help", no_argument, 0, 'h'},
+    {"threads", required_argument, 0, 't'},
+    {"strategy", required_argument, 0, 's'},
+    {"budget", required_argument, 0, 'b'},
+    {"seed", required_argument, 0, 'r'},
+    {"iterations", required_argument, 0, 'i'},
+    {"restarts", required_argument, 0, 'k'},
+    {"max-hops", required_argument, 0, 'm'},
+    {"comm-weight", required_argument, 0, 'c'},
+    {"verbose", no_argument, 0, 'v'},
+    {"stats-json", required_argument, 0, 'j'},
+    {"variants", required_argument, 0, 'V'},
+    {"top", required_argument, 0, 'n'},
+    {"cache", required_argument, 0, 'C'},
+    {"hierarchical", no_argument, 0, 'H'},
+    {"decompose", no_argument, 0, 'D'},
+    {"pareto", no_argument, 0, 'P'},
     {0,0,0,0}
 };
 
@@ -26,8 +59,243 @@ void usage (const char *myName)
     std::cout << myName << " <rcm_spec> <output>\n\n";
     std::cout << "Options:\n";
     std::cout << "--help\t" << "Show usage\n";
+    std::cout << "--threads <N>\t" << "Precompute the costs of all consumer/provider pairs and run restarts with N threads; in batch mode, map N variants at once (default: 1)\n";
+    std::cout << "--strategy <S>\t" << "Strategy to map implementations to processors: greedy (default), hungarian, mincostflow, branchandbound, annealing or multistart\n";
+    std::cout << "--budget <T>\t" << "Time budget of branchandbound and annealing in seconds (default: 10)\n";
+    std::cout << "--seed <N>\t" << "Seed of randomized strategies (default: 0)\n";
+    std::cout << "--iterations <N>\t" << "Maximum number of annealing steps (default: 10000)\n";
+    std::cout << "--restarts <K>\t" << "Number of greedy passes with different orders; implies multistart (default: 8)\n";
+    std::cout << "--max-hops <N>\t" << "Maximum number of links between the processors of communicating implementations (default: 1)\n";
+    std::cout << "--comm-weight <W>\t" << "Weight of the communication costs (traffic x hops between processors) in the objective (default: 1)\n";
+    std::cout << "--verbose\t" << "Print every rejected pair of consumer and provider and a summary of the rejections per rule (slow on large models)\n";
+    std::cout << "--stats-json <FILE>\t" << "Write the number of rejections per rule to FILE as JSON\n";
+    std::cout << "--variants <DIR>\t" << "Map every implementation network (*.yml) in DIR with the rcm_spec; the output is a prefix then\n";
+    std::cout << "--top <K>\t" << "Number of best variants to write in batch mode (default: 1)\n";
+    std::cout << "--hierarchical\t" << "Map level by level along the devices the processors are part of; subproblems are solved with N threads (see --threads)\n";
+    std::cout << "--decompose\t" << "Map the connected components of the sw and hw networks as separate subproblems with N threads (see --threads)\n";
+    std::cout << "--pareto\t" << "Write all mappings which are not dominated in load balance, communication costs and powered processors; the output is a prefix then\n";
+    std::cout << "--cache <DIR>\t" << "Reuse (and store) mapping results in DIR; unchanged inputs are restored, changed ones start from the most similar result\n";
     std::cout << "\nExample:\n";
     std::cout << myName << " rcm_spec.yml sw2hw_mapped.yml\n";
+    std::cout << myName << " --variants impl_nets/ --top 3 --threads 4 rcm_spec.yml mapped_\n";
+}
+
+// Returns the number starting at position i (without leading zeros) and moves i behind it
+static std::string numberAt(const std::string& s, std::size_t& i)
+{
+    const std::size_t start(i);
+    while ((i < s.size()) && std::isdigit(s[i]))
+        ++i;
+    std::string digits(s.substr(start, i - start));
+    digits.erase(0, std::min(digits.find_first_not_of('0'), digits.size() - 1));
+    return digits;
+}
+
+// Compares file names such that embedded numbers are ordered by value (net2.yml < net10.yml)
+static bool naturalLess(const std::string& a, const std::string& b)
+{
+    std::size_t i(0), j(0);
+    while ((i < a.size()) && (j < b.size()))
+    {
+        if (std::isdigit(a[i]) && std::isdigit(b[j]))
+        {
+            const std::string& x(numberAt(a, i));
+            const std::string& y(numberAt(b, j));
+            if (x.size() != y.size())
+                return x.size() < y.size();
+            if (x != y)
+                return x < y;
+            continue;
+        }
+        if (a[i] != b[j])
+            return a[i] < b[j];
+        ++i;
+        ++j;
+    }
+    return (a.size() - i) < (b.size() - j);
+}
+
+// Returns the names of all YAML files of a directory (in natural order)
+static std::vector< std::string > variantsIn(const std::string& dirName)
+{
+    std::vector< std::string > fileNames;
+    DIR* dir(opendir(dirName.c_str()));
+    if (!dir)
+        return fileNames;
+    for (struct dirent* entry = readdir(dir); entry; entry = readdir(dir))
+    {
+        const std::string fileName(entry->d_name);
+        if ((fileName.size() > 4) && (fileName.compare(fileName.size() - 4, 4, ".yml") == 0))
+            fileNames.push_back(fileName);
+    }
+    closedir(dir);
+    std::sort(fileNames.begin(), fileNames.end(), naturalLess);
+    return fileNames;
+}
+
+struct VariantResult
+{
+    std::string fileName;
+    float objective;
+    float slack;
+    float communication;
+    std::size_t unmapped;
+    std::string mapped;
+};
+
+// Better objectives first, ties by the order of the variants
+static bool better(const VariantResult& a, const std::size_t i, const VariantResult& b, const std::size_t j)
+{
+    if (a.objective != b.objective)
+        return a.objective > b.objective;
+    return i < j;
+}
+
+// The rejections are only counted if they are reported (see main)
+static void writeSummary()
+{
+    if (Diagnostics::counting())
+        Diagnostics::summary(std::cout);
+}
+
+static int mapVariants(const std::string& rcmFileName, const std::string& dirName, const std::string& outputPrefix,
+                       const ResourceCost::Solver& solver, const unsigned int threads, const unsigned int maxHops, const double commWeight, const std::size_t top,
+                       const Software::Hardware::MappingCache* cache, const bool hierarchical, const bool decompose)
+{
+    const std::vector< std::string >& fileNames(variantsIn(dirName));
+    if (fileNames.empty())
+    {
+        std::cout << "No variants found in " << dirName << "\n";
+        return -6;
+    }
+    std::cout << "#VARIANTS:\t\t" << fileNames.size() << "\n";
+    std::cout << "STRATEGY:\t\t" << solver.name() << "\n";
+
+    // The hardware and the resource model are shared by all variants
+    const ResourceCost::Model base(YAML::LoadFile(rcmFileName).as<Hypergraph>());
+
+    // Map the variants by a pool of workers. Only the mapped models of the best ones are kept.
+    std::vector< VariantResult > results(fileNames.size());
+    std::vector< std::size_t > best;
+    std::mutex bestMutex;
+    std::atomic< std::size_t > next(0);
+    auto worker = [&] () {
+        for (std::size_t i = next++; i < fileNames.size(); i = next++)
+        {
+            VariantResult& result(results[i]);
+            result.fileName = fileNames[i];
+            Software::Hardware::Mapper mapper(base, Software::Network(YAML::LoadFile(dirName + "/" + fileNames[i]).as<Hypergraph>()));
+            mapper.maxHops(maxHops);
+            mapper.communicationWeight(commWeight);
+            if (cache)
+                mapper.map(solver, *cache);
+            else if (hierarchical)
+                mapper.mapHierarchically(solver);
+            else if (decompose)
+                mapper.mapDecomposed(solver);
+            else
+                mapper.map(solver);
+            result.slack = mapper.globalCosts();
+            result.communication = mapper.communicationCosts();
+            result.objective = result.slack - commWeight * result.communication;
+            if (std::isnan(result.objective))
+                result.objective = -std::numeric_limits<float>::infinity();
+            result.unmapped = 0;
+            for (const UniqueId& implUid : Software::Hardware::Mapper::implementations(mapper))
+            {
+                if (mapper.providersOf(Hyperedges{implUid}).empty())
+                    ++result.unmapped;
+            }
+
+            std::lock_guard< std::mutex > lock(bestMutex);
+            std::cout << "VARIANT " << result.fileName << ": " << std::to_string(result.objective) << "\n";
+            std::vector< std::size_t >::iterator pos(best.begin());
+            while ((pos != best.end()) && better(results[*pos], *pos, result, i))
+                ++pos;
+            if (static_cast< std::size_t >(pos - best.begin()) >= top)
+                continue;
+            result.mapped = YAML::StringFrom(mapper);
+            best.insert(pos, i);
+            if (best.size() > top)
+            {
+                results[best.back()].mapped.clear();
+                best.pop_back();
+            }
+        }
+    };
+    std::vector< std::thread > pool;
+    for (unsigned int t = 1; (t < threads) && (t < fileNames.size()); ++t)
+        pool.push_back(std::thread(worker));
+    worker();
+    for (std::thread& t : pool)
+        t.join();
+
+    // Rank all variants and write the summary
+    std::vector< std::size_t > ranking(results.size());
+    for (std::size_t i = 0; i < ranking.size(); ++i)
+        ranking[i] = i;
+    std::sort(ranking.begin(), ranking.end(), [&] (const std::size_t i, const std::size_t j) { return better(results[i], i, results[j], j); });
+    std::ofstream csv(outputPrefix + "summary.csv");
+    if (!csv.good())
+    {
+        std::cout << "FAILED\n";
+        return -7;
+    }
+    csv << "rank,variant,objective,slack,communication,unmapped\n";
+    for (std::size_t r = 0; r < ranking.size(); ++r)
+    {
+        const VariantResult& result(results[ranking[r]]);
+        csv << r << "," << result.fileName << "," << result.objective << "," << result.slack << "," << result.communication << "," << result.unmapped << "\n";
+    }
+
+    // Store the best variants
+    for (const std::size_t i : best)
+    {
+        std::cout << "Variant " << results[i].fileName << " -> " << outputPrefix + results[i].fileName << "\n";
+        std::ofstream fout(outputPrefix + results[i].fileName);
+        if (fout.good())
+            fout << results[i].mapped << std::endl;
+        else
+            std::cout << "FAILED\n";
+    }
+    writeSummary();
+    return static_cast<int>(std::max(0.f, results[ranking[0]].objective)*100.f);
+}
+
+static int writeParetoFront(const Software::Hardware::Mapper& mapper, const ResourceCost::Solver& solver, const std::string& outputPrefix)
+{
+    const std::vector< Software::Hardware::Mapper >& front(mapper.paretoFront(solver));
+    std::ofstream csv(outputPrefix + "pareto.csv");
+    if (!csv.good())
+    {
+        std::cout << "FAILED\n";
+        return -7;
+    }
+    csv << "index,powered,communication,balance,slack,file\n";
+    for (std::size_t i = 0; i < front.size(); ++i)
+    {
+        const std::string fileName(outputPrefix + std::to_string(i) + ".yml");
+        std::cout << "Mapping " << i << ": powered processors: " << front[i].poweredProcessors() << ", communication costs: " << std::to_string(front[i].communicationCosts()) << ", balance: " << std::to_string(front[i].bottleneckSlack()) << " -> " << fileName << "\n";
+        csv << i << "," << front[i].poweredProcessors() << "," << front[i].communicationCosts() << "," << front[i].bottleneckSlack() << "," << front[i].globalCosts() << "," << fileName << "\n";
+        std::ofstream fout(fileName);
+        if (fout.good())
+            fout << YAML::StringFrom(front[i]) << std::endl;
+        else
+            std::cout << "FAILED\n";
+    }
+    writeSummary();
+    return static_cast<int>(front.size());
+}
+
+static void writeStats(const std::string& statsFileName)
+{
+    if (statsFileName.empty())
+        return;
+    std::ofstream stats(statsFileName);
+    if (stats.good())
+        Diagnostics::json(stats);
+    else
+        std::cout << "Cannot write " << statsFileName << "\n";
 }
 
 int main (int argc, char **argv)
@@ -35,16 +303,80 @@ int main (int argc, char **argv)
     std::cout << "Software to Hardware Mapper using Resource Cost Model\n";
 
     // Parse command line
+    unsigned int threads = 1;
+    std::string strategy;
+    double budget = 10.0;
+    unsigned long seed = 0;
+    std::size_t iterations = 10000;
+    std::size_t restarts = 0;
+    unsigned int maxHops = 1;
+    double commWeight = 1.0;
+    bool verbose = false;
+    std::string statsFileName;
+    std::string variantsDirName;
+    std::size_t top = 1;
+    std::string cacheDirName;
+    bool hierarchical = false;
+    bool decompose = false;
+    bool pareto = false;
     int c;
     while (1)
     {
         int option_index = 0;
-        c = getopt_long(argc, argv, "h", long_options, &option_index);
+        c = getopt_long(argc, argv, "ht:s:b:r:i:k:m:c:vj:V:n:C:HDP", long_options, &option_index);
         if (c == -1)
             break;
 
         switch (c)
         {
+            case 't':
+                threads = std::max(1, std::atoi(optarg));
+                break;
+            case 's':
+                strategy = std::string(optarg);
+                break;
+            case 'b':
+                budget = std::max(0.0, std::atof(optarg));
+                break;
+            case 'r':
+                seed = std::strtoul(optarg, NULL, 10);
+                break;
+            case 'i':
+                iterations = std::strtoul(optarg, NULL, 10);
+                break;
+            case 'k':
+                restarts = std::max(1ul, std::strtoul(optarg, NULL, 10));
+                break;
+            case 'm':
+                maxHops = std::max(1, std::atoi(optarg));
+                break;
+            case 'c':
+                commWeight = std::max(0.0, std::atof(optarg));
+                break;
+            case 'v':
+                verbose = true;
+                break;
+            case 'j':
+                statsFileName = std::string(optarg);
+                break;
+            case 'V':
+                variantsDirName = std::string(optarg);
+                break;
+            case 'n':
+                top = std::max(1ul, std::strtoul(optarg, NULL, 10));
+                break;
+            case 'C':
+                cacheDirName = std::string(optarg);
+                break;
+            case 'H':
+                hierarchical = true;
+                break;
+            case 'D':
+                decompose = true;
+                break;
+            case 'P':
+                pareto = true;
+                break;
             case 'h':
             case '?':
                 break;
@@ -54,20 +386,72 @@ int main (int argc, char **argv)
         }
     }
 
+    if (strategy.empty())
+        strategy = restarts ? "multistart" : "greedy";
+
     if ((argc - optind) < 2)
     {
         usage(argv[0]);
         return -1;
     }
 
+    // The ways of mapping exclude each other
+    if ((!cacheDirName.empty() + hierarchical + decompose + pareto) > 1)
+    {
+        std::cout << "Only one of --cache, --hierarchical, --decompose and --pareto can be used\n";
+        usage(argv[0]);
+        return -1;
+    }
+    if (pareto && !variantsDirName.empty())
+    {
+        std::cout << "--pareto cannot be used with --variants\n";
+        usage(argv[0]);
+        return -1;
+    }
+
+    // Select solver
+    const ResourceCost::Solver greedy;
+    const ResourceCost::AssignmentSolver hungarian(ResourceCost::AssignmentSolver::UNIT_CAPACITY);
+    const ResourceCost::AssignmentSolver mincostflow(ResourceCost::AssignmentSolver::UNIFORM_DEMANDS);
+    const ResourceCost::BranchAndBoundSolver branchandbound(budget, Software::Hardware::Mapper::equivalentProcessors);
+    const ResourceCost::AnnealingSolver annealing(seed, iterations, budget);
+    const ResourceCost::MultiStartSolver multistart(restarts ? restarts : 8, seed);
+    const std::vector< const ResourceCost::Solver* > solvers{&greedy, &hungarian, &mincostflow, &branchandbound, &annealing, &multistart};
+    const ResourceCost::Solver* solver(NULL);
+    for (const ResourceCost::Solver* candidate : solvers)
+    {
+        if (candidate->name() == strategy)
+            solver = candidate;
+    }
+    if (!solver)
+    {
+        std::cout << "Unknown strategy " << strategy << "\n";
+        usage(argv[0]);
+        return -1;
+    }
+
+    // Print all rejections and count them only if requested (counting costs an atomic increment per rejection)
+    Diagnostics::level(verbose ? Diagnostics::DEBUG : Diagnostics::INFO);
+    Diagnostics::counting(verbose || !statsFileName.empty());
+
     // Set vars
     const std::string rcmFileName(argv[optind]);
     const std::string fileNameOut(argv[optind+1]);
+    std::unique_ptr< Software::Hardware::MappingCache > cache(cacheDirName.empty() ? NULL : new Software::Hardware::MappingCache(cacheDirName));
+    if (!variantsDirName.empty())
+    {
+        const int result(mapVariants(rcmFileName, variantsDirName, fileNameOut, *solver, threads, maxHops, commWeight, top, cache.get(), hierarchical, decompose));
+        writeStats(statsFileName);
+        return result;
+    }
     Software::Hardware::Mapper mapper(YAML::LoadFile(rcmFileName).as<Hypergraph>());
+    mapper.threads(threads);
+    mapper.maxHops(maxHops);
+    mapper.communicationWeight(commWeight);
 
     // Print out some statistics
-    Software::Network sw(mapper);
-    Hardware::Computational::Network hw(mapper);
+    const Software::NetworkView sw(mapper);
+    const Hardware::Computational::NetworkView hw(mapper);
     const unsigned int impls(sw.implementations().size());
     const unsigned int procs(hw.processors().size());
     const unsigned int swIfs(sw.interfacesOf(sw.implementations()).size());
@@ -102,7 +486,22 @@ int main (int argc, char **argv)
     std::cout << "#CONSUMERS:\t\t" << nConsumers << "\n";
     std::cout << "#PROVIDERS:\t\t" << nProviders << "\n";
 
-    float globalCosts = mapper.map();
+    std::cout << "STRATEGY:\t\t" << solver->name() << "\n";
+    if (pareto)
+    {
+        const int result(writeParetoFront(mapper, *solver, fileNameOut));
+        writeStats(statsFileName);
+        return result;
+    }
+    float globalCosts;
+    if (cache)
+        globalCosts = mapper.map(*solver, *cache);
+    else if (hierarchical)
+        globalCosts = mapper.mapHierarchically(*solver);
+    else if (decompose)
+        globalCosts = mapper.mapDecomposed(*solver);
+    else
+        globalCosts = mapper.map(*solver);
 
     // Print mapping results & sum up remaining resources/max resources per target (or multiply it?)
     for (const UniqueId& swUid : sw.implementations())
@@ -117,6 +516,14 @@ int main (int argc, char **argv)
         // TODO: Print interface mapping
     }
     std::cout << "Global Normalized Costs: " << std::to_string(globalCosts) << "\n";
+    // Report the terms of the objective separately
+    const float slack(mapper.globalCosts());
+    const float communication(mapper.communicationCosts());
+    std::cout << "Resource Slack: " << std::to_string(slack) << "\n";
+    std::cout << "Communication Costs: " << std::to_string(communication) << " (weight: " << std::to_string(commWeight) << ")\n";
+    std::cout << "Objective: " << std::to_string(slack - commWeight * communication) << "\n";
+    writeSummary();
+    writeStats(statsFileName);
 
     // Store result
     std::ofstream fout;